@@ -1,6 +1,7 @@
 
 #include "strenum.h"
 
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <iostream>
@@ -49,7 +50,7 @@ namespace sae::cgen
 		_ostr << "#pragma once\n";
 		_ostr << "#include <SAELib_DualMap.h>\n";
 		_ostr << "#include <optional>\n";
-		_ostr << "#include <string>\n\n";
+		_ostr << "#include <string_view>\n\n";
 
 		if (!_settings.use_namespace.empty())
 		{
@@ -73,7 +74,17 @@ namespace sae::cgen
 
 		_ostr << "private:\n";
 
-		_ostr << "\tconst static inline ::sae::unordered_dualmap<std::string, " << _enum_name << "> STR_ENUM_DMAP\n\t{\n";
+		_ostr << "\tconstexpr static inline auto STR_ENUM_DMAP = ::sae::make_frozen_dualmap<" << _enum_name << ">";
+
+		// An empty braced list cannot be deduced as a zero length array, empty enums get the empty map overload
+		if (std::all_of(_evals.begin(), _evals.end(), [](const auto& v) { return v.empty(); }))
+		{
+			_ostr << "();\n";
+		}
+		else
+		{
+			_ostr << "\n\t({\n";
+		};
 
 		bool _ranOnce = false;
 		for (auto& v : _evals)
@@ -92,7 +103,10 @@ namespace sae::cgen
 			_ranOnce = true;
 
 		};
-		_ostr << "\n\t};\n";
+		if (_ranOnce)
+		{
+			_ostr << "\n\t});\n";
+		};
 		_ostr << '\t' << _enum_name << " val_;\n\n";
 
 		_ostr << "public:\n";
@@ -105,12 +119,12 @@ namespace sae::cgen
 		_ostr << "\texplicit operator bool() noexcept = delete;\n\n";
 
 
-		_ostr << "\tstatic inline std::optional<" << _enum_name << "> from_string(const std::string& _str)\n";
+		_ostr << "\tstatic constexpr std::optional<" << _enum_name << "> from_string(std::string_view _str)\n";
 		_ostr << "\t{\n\t\tstd::optional<" << _enum_name << "> _out{ std::nullopt };\n";
-		_ostr << "\t\tif(STR_ENUM_DMAP.contains_left(_str))\n\t\t{\n\t\t\t_out = STR_ENUM_DMAP.ltor(_str);\n\t\t};\n";
+		_ostr << "\t\tif (const auto _val = STR_ENUM_DMAP.find_left(_str); _val)\n\t\t{\n\t\t\t_out = _val->get();\n\t\t};\n";
 		_ostr << "\t\treturn _out;\n\t};\n";
 
-		_ostr << "\tconst std::string& to_string() const\n\t{\n";
+		_ostr << "\tconstexpr std::string_view to_string() const\n\t{\n";
 		_ostr << "\t\treturn STR_ENUM_DMAP.rtol(this->val_);\n\t};\n\n";
 
 		_ostr << "\tconstexpr inline operator " << _enum_name << "() const noexcept { return this->val_; };\n";
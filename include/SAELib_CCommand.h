@@ -10,6 +10,7 @@
 #include <unordered_map>
 #include <concepts>
 #include <string_view>
+#include <functional>
 
 namespace sae
 {
@@ -8,6 +8,7 @@
 #include <type_traits>
 #include <string>
 #include <utility>
+#include <cmath>
 
 namespace sae
 {
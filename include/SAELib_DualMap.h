@@ -1,11 +1,61 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <functional>
+#include <initializer_list>
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+#include <array>
+#include <optional>
+#include <algorithm>
+#include <string>
+#include <string_view>
 
 namespace sae
 {
 
-	template <typename LT, typename RT>
+	namespace impl
+	{
+		template <typename HashT, typename EqualT>
+		concept cx_transparent_lookup = requires
+		{
+			typename HashT::is_transparent;
+			typename EqualT::is_transparent;
+		};
+
+		/**
+		 * @brief Default dual map hash, strings hash as views so they can be looked up without a temporary string
+		*/
+		template <typename T>
+		struct dualmap_hash : public std::hash<T> {};
+
+		template <typename CharT, typename TraitsT, typename AllocT>
+		struct dualmap_hash<std::basic_string<CharT, TraitsT, AllocT>>
+		{
+			using is_transparent = void;
+			size_t operator()(std::basic_string_view<CharT, TraitsT> _str) const noexcept
+			{
+				return std::hash<std::basic_string_view<CharT, TraitsT>>{}(_str);
+			};
+		};
+
+		template <typename T>
+		struct dualmap_equal : public std::equal_to<T> {};
+
+		template <typename CharT, typename TraitsT, typename AllocT>
+		struct dualmap_equal<std::basic_string<CharT, TraitsT, AllocT>> : public std::equal_to<> {};
+	};
+
+	template
+	<
+		typename LT, typename RT,
+		typename LHashT = impl::dualmap_hash<LT>, typename RHashT = impl::dualmap_hash<RT>,
+		typename LEqualT = impl::dualmap_equal<LT>, typename REqualT = impl::dualmap_equal<RT>
+	>
 	struct unordered_dualmap
 	{
 	public:
@@ -20,6 +70,27 @@ namespace sae
 		{
 			return this->l_to_r_.at(_l);
 		};
+		template <typename KeyT> requires impl::cx_transparent_lookup<LHashT, LEqualT>
+		const right_type& ltor(const KeyT& _l) const
+		{
+			const auto it = this->l_to_r_.find(_l);
+			if (it == this->l_to_r_.end())
+			{
+				throw std::out_of_range{ "unordered_dualmap::ltor" };
+			};
+			return it->second;
+		};
+		// Non const overload so a non const map does not see this and the non template overload as equally good
+		template <typename KeyT> requires impl::cx_transparent_lookup<LHashT, LEqualT>
+		right_type& ltor(const KeyT& _l)
+		{
+			const auto it = this->l_to_r_.find(_l);
+			if (it == this->l_to_r_.end())
+			{
+				throw std::out_of_range{ "unordered_dualmap::ltor" };
+			};
+			return it->second;
+		};
 
 		left_type& rtol(const right_type& _l)
 		{
@@ -29,6 +100,56 @@ namespace sae
 		{
 			return this->r_to_l_.at(_l);
 		};
+		template <typename KeyT> requires impl::cx_transparent_lookup<RHashT, REqualT>
+		const left_type& rtol(const KeyT& _r) const
+		{
+			const auto it = this->r_to_l_.find(_r);
+			if (it == this->r_to_l_.end())
+			{
+				throw std::out_of_range{ "unordered_dualmap::rtol" };
+			};
+			return it->second;
+		};
+		template <typename KeyT> requires impl::cx_transparent_lookup<RHashT, REqualT>
+		left_type& rtol(const KeyT& _r)
+		{
+			const auto it = this->r_to_l_.find(_r);
+			if (it == this->r_to_l_.end())
+			{
+				throw std::out_of_range{ "unordered_dualmap::rtol" };
+			};
+			return it->second;
+		};
+
+		/**
+		 * @brief Finds the right value mapped to _l without throwing
+		*/
+		std::optional<std::reference_wrapper<const right_type>> find_left(const left_type& _l) const
+		{
+			const auto it = this->l_to_r_.find(_l);
+			return (it != this->l_to_r_.end()) ? std::optional{ std::cref(it->second) } : std::nullopt;
+		};
+		template <typename KeyT> requires impl::cx_transparent_lookup<LHashT, LEqualT>
+		std::optional<std::reference_wrapper<const right_type>> find_left(const KeyT& _l) const
+		{
+			const auto it = this->l_to_r_.find(_l);
+			return (it != this->l_to_r_.end()) ? std::optional{ std::cref(it->second) } : std::nullopt;
+		};
+
+		/**
+		 * @brief Finds the left value mapped to _r without throwing
+		*/
+		std::optional<std::reference_wrapper<const left_type>> find_right(const right_type& _r) const
+		{
+			const auto it = this->r_to_l_.find(_r);
+			return (it != this->r_to_l_.end()) ? std::optional{ std::cref(it->second) } : std::nullopt;
+		};
+		template <typename KeyT> requires impl::cx_transparent_lookup<RHashT, REqualT>
+		std::optional<std::reference_wrapper<const left_type>> find_right(const KeyT& _r) const
+		{
+			const auto it = this->r_to_l_.find(_r);
+			return (it != this->r_to_l_.end()) ? std::optional{ std::cref(it->second) } : std::nullopt;
+		};
 
 		void insert(const std::pair<left_type, right_type>& _pair)
 		{
@@ -36,22 +157,63 @@ namespace sae
 			this->r_to_l_.insert({ _pair.second, _pair.first });
 		};
 
+		/**
+		 * @brief Constructs a pair in place if neither side is already mapped
+		 * @return True if the pair was inserted
+		*/
+		template <typename LArgT, typename RArgT>
+		bool emplace(LArgT&& _l, RArgT&& _r)
+		{
+			const auto [it, _inserted] = this->l_to_r_.try_emplace(std::forward<LArgT>(_l), std::forward<RArgT>(_r));
+			if (!_inserted)
+			{
+				return false;
+			};
+			if (!this->r_to_l_.try_emplace(it->second, it->first).second)
+			{
+				this->l_to_r_.erase(it);
+				return false;
+			};
+			return true;
+		};
+
 		bool contains_left(const left_type& _l) const
 		{
 			return this->l_to_r_.count(_l) != 0;
 		};
+		template <typename KeyT> requires impl::cx_transparent_lookup<LHashT, LEqualT>
+		bool contains_left(const KeyT& _l) const
+		{
+			return this->l_to_r_.find(_l) != this->l_to_r_.end();
+		};
 		bool contains_right(const right_type& _r) const
 		{
 			return this->r_to_l_.count(_r) != 0;
 		};
+		template <typename KeyT> requires impl::cx_transparent_lookup<RHashT, REqualT>
+		bool contains_right(const KeyT& _r) const
+		{
+			return this->r_to_l_.find(_r) != this->r_to_l_.end();
+		};
 
+		size_t size() const noexcept { return this->l_to_r_.size(); };
+		bool empty() const noexcept { return this->l_to_r_.empty(); };
 
+		/**
+		 * @brief Makes room for _count pairs in both directions without rehashing
+		*/
+		void reserve(size_t _count)
+		{
+			this->l_to_r_.reserve(_count);
+			this->r_to_l_.reserve(_count);
+		};
 
 
 
 		unordered_dualmap() = default;
 		unordered_dualmap(std::initializer_list<std::pair<left_type, right_type>> _pairs)
 		{
+			this->reserve(_pairs.size());
 			for (const auto& p : _pairs)
 			{
 				this->insert(p);
@@ -59,13 +221,738 @@ namespace sae
 		};
 
 	private:
-		std::unordered_map<LT, RT> l_to_r_{};
-		std::unordered_map<RT, LT> r_to_l_{};
+		std::unordered_map<LT, RT, LHashT, LEqualT> l_to_r_{};
+		std::unordered_map<RT, LT, RHashT, REqualT> r_to_l_{};
 
 	};
 
+	namespace impl
+	{
+		/**
+		 * @brief Robin Hood open addressing table that maps hashes to indices into a separate value array
+		 * 
+		 * The table never sees the keys, lookups are given a predicate that compares the key stored at an index.
+		 * Each slot keeps its probe distance and an 8 bit fingerprint of the hash so most mismatches are rejected
+		 * without touching the value array.
+		*/
+		class dense_index_table
+		{
+		public:
+			constexpr static uint32_t npos = UINT32_MAX;
 
+		private:
+			struct slot
+			{
+				// (probe distance + 1) << 8 | fingerprint, zero if the slot is empty
+				uint32_t meta = 0;
+				uint32_t index = 0;
+			};
 
+			constexpr static uint32_t DIST_ONE_V = 1 << 8;
 
-}
+			static uint64_t mix(size_t _hash) noexcept
+			{
+				return (uint64_t)_hash * 0x9E3779B97F4A7C15ull;
+			};
+			static uint32_t first_meta(uint64_t _mixed) noexcept
+			{
+				return DIST_ONE_V | (uint32_t)(_mixed & 0xFF);
+			};
+			static uint32_t distance(uint32_t _meta) noexcept
+			{
+				return _meta >> 8;
+			};
+
+			size_t home(uint64_t _mixed) const noexcept
+			{
+				return (size_t)(_mixed >> this->shift_);
+			};
+			size_t mask() const noexcept
+			{
+				return this->slots_.size() - 1;
+			};
 
+			size_t locate(size_t _hash, uint32_t _index) const noexcept
+			{
+				auto _pos = this->home(mix(_hash));
+				while (this->slots_[_pos].meta == 0 || this->slots_[_pos].index != _index)
+				{
+					_pos = (_pos + 1) & this->mask();
+				};
+				return _pos;
+			};
+
+		public:
+			size_t capacity() const noexcept { return this->slots_.size(); };
+
+			/**
+			 * @brief Finds the index whose key matches
+			 * @param _equal Predicate called with a candidate index
+			 * @return The matching index or npos
+			*/
+			template <typename EqualF>
+			uint32_t find(size_t _hash, EqualF&& _equal) const
+			{
+				if (this->slots_.empty())
+				{
+					return npos;
+				};
+
+				const auto _mixed = mix(_hash);
+				auto _meta = first_meta(_mixed);
+				auto _pos = this->home(_mixed);
+				while (true)
+				{
+					const auto& _slot = this->slots_[_pos];
+					if (_slot.meta == _meta && _equal(_slot.index))
+					{
+						return _slot.index;
+					};
+
+					// A richer slot would have been displaced by the key had it been inserted
+					if (distance(_slot.meta) < distance(_meta))
+					{
+						return npos;
+					};
+
+					_meta += DIST_ONE_V;
+					_pos = (_pos + 1) & this->mask();
+				};
+			};
+
+			/**
+			 * @brief Inserts an index whose key is not in the table yet, capacity must already be available
+			*/
+			void insert(size_t _hash, uint32_t _index) noexcept
+			{
+				const auto _mixed = mix(_hash);
+				slot _current{ first_meta(_mixed), _index };
+				auto _pos = this->home(_mixed);
+				while (true)
+				{
+					auto& _slot = this->slots_[_pos];
+					if (_slot.meta == 0)
+					{
+						_slot = _current;
+						return;
+					};
+					if (distance(_slot.meta) < distance(_current.meta))
+					{
+						std::swap(_slot, _current);
+					};
+					_current.meta += DIST_ONE_V;
+					_pos = (_pos + 1) & this->mask();
+				};
+			};
+
+			/**
+			 * @brief Removes an index using backward shift deletion
+			*/
+			void erase(size_t _hash, uint32_t _index) noexcept
+			{
+				auto _pos = this->locate(_hash, _index);
+				auto _next = (_pos + 1) & this->mask();
+				while (distance(this->slots_[_next].meta) > 1)
+				{
+					this->slots_[_pos] = this->slots_[_next];
+					this->slots_[_pos].meta -= DIST_ONE_V;
+					_pos = _next;
+					_next = (_next + 1) & this->mask();
+				};
+				this->slots_[_pos] = slot{};
+			};
+
+			/**
+			 * @brief Points the slot holding _from at _to, used when a value is moved within the value array
+			*/
+			void relabel(size_t _hash, uint32_t _from, uint32_t _to) noexcept
+			{
+				this->slots_[this->locate(_hash, _from)].index = _to;
+			};
+
+			/**
+			 * @brief Resizes the table and reinserts indices [0, _count)
+			 * @param _capacity Power of two slot count
+			 * @param _hashOf Returns the hash of the key stored at an index
+			*/
+			template <typename HashOfF>
+			void rebuild(size_t _capacity, uint32_t _count, HashOfF&& _hashOf)
+			{
+				this->slots_.assign(_capacity, slot{});
+				this->shift_ = 64 - (size_t)std::countr_zero(_capacity);
+				for (uint32_t n = 0; n != _count; ++n)
+				{
+					this->insert(_hashOf(n), n);
+				};
+			};
+
+			void clear() noexcept
+			{
+				std::fill(this->slots_.begin(), this->slots_.end(), slot{});
+			};
+
+		private:
+			std::vector<slot> slots_{};
+			size_t shift_ = 64;
+
+		};
+	};
+
+	/**
+	 * @brief Dual map storing each pair once in a dense array with two open addressing index tables
+	 * 
+	 * Lookups in either direction probe a flat table and then read a single pair, and iteration walks a contiguous
+	 * array. Erasing moves the last pair into the hole so references are invalidated by erase as well as insert.
+	 * Holds at most UINT32_MAX - 1 pairs.
+	*/
+	template
+	<
+		typename LT, typename RT,
+		typename LHashT = impl::dualmap_hash<LT>, typename RHashT = impl::dualmap_hash<RT>,
+		typename LEqualT = impl::dualmap_equal<LT>, typename REqualT = impl::dualmap_equal<RT>
+	>
+	class dense_dualmap
+	{
+	public:
+		using left_type = LT;
+		using right_type = RT;
+		using value_type = std::pair<left_type, right_type>;
+		using size_type = size_t;
+
+		using container_type = std::vector<value_type>;
+		using const_iterator = typename container_type::const_iterator;
+		using iterator = const_iterator;
+
+	private:
+		constexpr static size_t MIN_CAPACITY_V = 8;
+
+		template <typename KeyT>
+		uint32_t find_left_index(const KeyT& _l) const
+		{
+			return this->left_.find(this->lhash_(_l), [this, &_l](uint32_t i)
+				{
+					return this->lequal_(this->values_[i].first, _l);
+				});
+		};
+		template <typename KeyT>
+		uint32_t find_right_index(const KeyT& _r) const
+		{
+			return this->right_.find(this->rhash_(_r), [this, &_r](uint32_t i)
+				{
+					return this->requal_(this->values_[i].second, _r);
+				});
+		};
+
+		void rebuild(size_t _capacity)
+		{
+			const auto _count = (uint32_t)this->values_.size();
+			this->left_.rebuild(_capacity, _count, [this](uint32_t i) { return this->lhash_(this->values_[i].first); });
+			this->right_.rebuild(_capacity, _count, [this](uint32_t i) { return this->rhash_(this->values_[i].second); });
+		};
+
+		// Keeps the load factor at or below 80%
+		static size_t capacity_for(size_t _count) noexcept
+		{
+			return std::max(MIN_CAPACITY_V, std::bit_ceil(_count + _count / 4 + 1));
+		};
+
+		void erase_at(uint32_t _index)
+		{
+			const auto _last = (uint32_t)this->values_.size() - 1;
+			this->left_.erase(this->lhash_(this->values_[_index].first), _index);
+			this->right_.erase(this->rhash_(this->values_[_index].second), _index);
+			if (_index != _last)
+			{
+				auto& _moved = this->values_[_last];
+				this->left_.relabel(this->lhash_(_moved.first), _last, _index);
+				this->right_.relabel(this->rhash_(_moved.second), _last, _index);
+				this->values_[_index] = std::move(_moved);
+			};
+			this->values_.pop_back();
+		};
+
+	public:
+		const_iterator begin() const noexcept { return this->values_.cbegin(); };
+		const_iterator end() const noexcept { return this->values_.cend(); };
+
+		size_type size() const noexcept { return this->values_.size(); };
+		bool empty() const noexcept { return this->values_.empty(); };
+
+		/**
+		 * @brief Makes room for _count pairs without rehashing
+		*/
+		void reserve(size_type _count)
+		{
+			this->values_.reserve(_count);
+			const auto _capacity = capacity_for(_count);
+			if (_capacity > this->left_.capacity())
+			{
+				this->rebuild(_capacity);
+			};
+		};
+
+		const right_type& ltor(const left_type& _l) const
+		{
+			return this->template ltor<left_type>(_l);
+		};
+		template <typename KeyT> requires std::same_as<KeyT, left_type> || impl::cx_transparent_lookup<LHashT, LEqualT>
+		const right_type& ltor(const KeyT& _l) const
+		{
+			const auto i = this->find_left_index(_l);
+			if (i == impl::dense_index_table::npos)
+			{
+				throw std::out_of_range{ "dense_dualmap::ltor" };
+			};
+			return this->values_[i].second;
+		};
+
+		const left_type& rtol(const right_type& _r) const
+		{
+			return this->template rtol<right_type>(_r);
+		};
+		template <typename KeyT> requires std::same_as<KeyT, right_type> || impl::cx_transparent_lookup<RHashT, REqualT>
+		const left_type& rtol(const KeyT& _r) const
+		{
+			const auto i = this->find_right_index(_r);
+			if (i == impl::dense_index_table::npos)
+			{
+				throw std::out_of_range{ "dense_dualmap::rtol" };
+			};
+			return this->values_[i].first;
+		};
+
+		std::optional<std::reference_wrapper<const right_type>> find_left(const left_type& _l) const
+		{
+			return this->template find_left<left_type>(_l);
+		};
+		template <typename KeyT> requires std::same_as<KeyT, left_type> || impl::cx_transparent_lookup<LHashT, LEqualT>
+		std::optional<std::reference_wrapper<const right_type>> find_left(const KeyT& _l) const
+		{
+			const auto i = this->find_left_index(_l);
+			return (i != impl::dense_index_table::npos) ? std::optional{ std::cref(this->values_[i].second) } : std::nullopt;
+		};
+
+		std::optional<std::reference_wrapper<const left_type>> find_right(const right_type& _r) const
+		{
+			return this->template find_right<right_type>(_r);
+		};
+		template <typename KeyT> requires std::same_as<KeyT, right_type> || impl::cx_transparent_lookup<RHashT, REqualT>
+		std::optional<std::reference_wrapper<const left_type>> find_right(const KeyT& _r) const
+		{
+			const auto i = this->find_right_index(_r);
+			return (i != impl::dense_index_table::npos) ? std::optional{ std::cref(this->values_[i].first) } : std::nullopt;
+		};
+
+		bool contains_left(const left_type& _l) const
+		{
+			return this->find_left_index(_l) != impl::dense_index_table::npos;
+		};
+		template <typename KeyT> requires impl::cx_transparent_lookup<LHashT, LEqualT>
+		bool contains_left(const KeyT& _l) const
+		{
+			return this->find_left_index(_l) != impl::dense_index_table::npos;
+		};
+		bool contains_right(const right_type& _r) const
+		{
+			return this->find_right_index(_r) != impl::dense_index_table::npos;
+		};
+		template <typename KeyT> requires impl::cx_transparent_lookup<RHashT, REqualT>
+		bool contains_right(const KeyT& _r) const
+		{
+			return this->find_right_index(_r) != impl::dense_index_table::npos;
+		};
+
+		/**
+		 * @brief Inserts a pair if neither side is already mapped
+		 * @return True if the pair was inserted
+		*/
+		bool insert(value_type _pair)
+		{
+			if (this->contains_left(_pair.first) || this->contains_right(_pair.second))
+			{
+				return false;
+			};
+
+			if (capacity_for(this->values_.size() + 1) > this->left_.capacity())
+			{
+				this->rebuild(capacity_for((this->values_.size() + 1) * 2));
+			};
+
+			const auto i = (uint32_t)this->values_.size();
+			const auto& _inserted = this->values_.emplace_back(std::move(_pair));
+			this->left_.insert(this->lhash_(_inserted.first), i);
+			this->right_.insert(this->rhash_(_inserted.second), i);
+			return true;
+		};
+
+		/**
+		 * @brief Constructs a pair in place if neither side is already mapped
+		 * @return True if the pair was inserted
+		*/
+		template <typename LArgT, typename RArgT>
+		bool emplace(LArgT&& _l, RArgT&& _r)
+		{
+			return this->insert(value_type{ std::forward<LArgT>(_l), std::forward<RArgT>(_r) });
+		};
+
+		/**
+		 * @brief Removes the pair with the given left value
+		 * @return True if a pair was removed
+		*/
+		bool erase_left(const left_type& _l)
+		{
+			const auto i = this->find_left_index(_l);
+			if (i == impl::dense_index_table::npos)
+			{
+				return false;
+			};
+			this->erase_at(i);
+			return true;
+		};
+
+		/**
+		 * @brief Removes the pair with the given right value
+		 * @return True if a pair was removed
+		*/
+		bool erase_right(const right_type& _r)
+		{
+			const auto i = this->find_right_index(_r);
+			if (i == impl::dense_index_table::npos)
+			{
+				return false;
+			};
+			this->erase_at(i);
+			return true;
+		};
+
+		void clear() noexcept
+		{
+			this->values_.clear();
+			this->left_.clear();
+			this->right_.clear();
+		};
+
+		dense_dualmap() = default;
+		dense_dualmap(std::initializer_list<value_type> _pairs)
+		{
+			this->reserve(_pairs.size());
+			for (const auto& p : _pairs)
+			{
+				this->insert(p);
+			};
+		};
+
+	private:
+		container_type values_{};
+		impl::dense_index_table left_{};
+		impl::dense_index_table right_{};
+		[[no_unique_address]] LHashT lhash_{};
+		[[no_unique_address]] RHashT rhash_{};
+		[[no_unique_address]] LEqualT lequal_{};
+		[[no_unique_address]] REqualT requal_{};
+
+	};
+
+	namespace impl
+	{
+		/**
+		 * @brief Seeded FNV-1a used by frozen_dualmap, finished with a multiply and fold so every seed gives well mixed low bits
+		*/
+		constexpr uint64_t frozen_hash(std::string_view _str, uint64_t _seed) noexcept
+		{
+			uint64_t _hash = 0xcbf29ce484222325ull ^ (_seed * 0x9E3779B97F4A7C15ull);
+			for (const auto c : _str)
+			{
+				_hash ^= (uint8_t)c;
+				_hash *= 0x100000001b3ull;
+			};
+			_hash ^= _hash >> 33;
+			_hash *= 0xff51afd7ed558ccdull;
+			_hash ^= _hash >> 33;
+			return _hash;
+		};
+	};
+
+	/**
+	 * @brief Immutable dual map from strings to values that is built entirely at compile time
+	 * 
+	 * String lookups use a minimal perfect hash built with hash and displace: keys are grouped into buckets by one
+	 * hash and each bucket stores the seed of a second hash that places its keys in free slots. A lookup is two hashes
+	 * and one string compare. Value lookups index straight into the pairs sorted by value when the values have no
+	 * gaps, as generated enums do, and binary search otherwise.
+	 * 
+	 * Keys are views so the strings must outlive the map, string literals are the intended use. Building maps with
+	 * thousands of pairs at compile time may need the compiler's constexpr step limit raised.
+	 * 
+	 * @tparam RT Value type, must be ordered with <
+	 * @tparam N Number of pairs, empty maps are a separate specialization below
+	*/
+	template <typename RT, size_t N>
+	class frozen_dualmap
+	{
+	public:
+		using left_type = std::string_view;
+		using right_type = RT;
+		using value_type = std::pair<left_type, right_type>;
+		using size_type = size_t;
+
+		using container_type = std::array<value_type, N>;
+		using const_iterator = typename container_type::const_iterator;
+		using iterator = const_iterator;
+
+	private:
+		constexpr static size_t slot_of(left_type _l, uint64_t _seed) noexcept
+		{
+			return (size_t)(impl::frozen_hash(_l, _seed) % N);
+		};
+		constexpr static size_t bucket_of(left_type _l) noexcept
+		{
+			return slot_of(_l, 0);
+		};
+
+		constexpr const value_type* find_left_pair(left_type _l) const noexcept
+		{
+			const auto& _pair = this->by_left_[slot_of(_l, this->seeds_[bucket_of(_l)])];
+			return (_pair.first == _l) ? &_pair : nullptr;
+		};
+		constexpr const value_type* find_right_pair(const right_type& _r) const noexcept
+		{
+			if constexpr (std::is_enum_v<right_type> || std::is_integral_v<right_type>)
+			{
+				const auto _index = (size_t)((uint64_t)_r - (uint64_t)this->by_right_.front().second);
+				if (_index < N && this->by_right_[_index].second == _r)
+				{
+					return &this->by_right_[_index];
+				};
+			};
+
+			const auto _it = std::lower_bound(this->by_right_.begin(), this->by_right_.end(), _r, [](const value_type& _pair, const right_type& _value)
+				{
+					return _pair.second < _value;
+				});
+			return (_it != this->by_right_.end() && _it->second == _r) ? &*_it : nullptr;
+		};
+
+		constexpr void build_right(const value_type(&_pairs)[N])
+		{
+			std::copy(std::begin(_pairs), std::end(_pairs), this->by_right_.begin());
+			std::sort(this->by_right_.begin(), this->by_right_.end(), [](const value_type& _lhs, const value_type& _rhs)
+				{
+					return _lhs.second < _rhs.second;
+				});
+			for (size_t n = 1; n < N; ++n)
+			{
+				if (!(this->by_right_[n - 1].second < this->by_right_[n].second))
+				{
+					throw std::invalid_argument{ "frozen_dualmap has a duplicate right value" };
+				};
+			};
+		};
+
+		constexpr void build_left(const value_type(&_pairs)[N])
+		{
+			std::array<size_t, N> _bucketOf{};
+			std::array<size_t, N> _bucketSizes{};
+			for (size_t n = 0; n != N; ++n)
+			{
+				_bucketOf[n] = bucket_of(_pairs[n].first);
+				++_bucketSizes[_bucketOf[n]];
+			};
+
+			// Group the keys by bucket and place the largest buckets first while there are still plenty of free slots
+			std::array<size_t, N> _keys{};
+			for (size_t n = 0; n != N; ++n)
+			{
+				_keys[n] = n;
+			};
+			std::sort(_keys.begin(), _keys.end(), [&_bucketOf, &_bucketSizes](size_t _lhs, size_t _rhs)
+				{
+					const auto _lhsBucket = _bucketOf[_lhs];
+					const auto _rhsBucket = _bucketOf[_rhs];
+					if (_bucketSizes[_lhsBucket] != _bucketSizes[_rhsBucket])
+					{
+						return _bucketSizes[_lhsBucket] > _bucketSizes[_rhsBucket];
+					};
+					return _lhsBucket < _rhsBucket;
+				});
+
+			std::array<bool, N> _taken{};
+			std::array<size_t, N> _slots{};
+			for (size_t _first = 0; _first != N; )
+			{
+				const auto _bucket = _bucketOf[_keys[_first]];
+				const auto _count = _bucketSizes[_bucket];
+				const auto _members = _keys.data() + _first;
+				_first += _count;
+
+				for (size_t m = 0; m != _count; ++m)
+				{
+					for (size_t p = 0; p != m; ++p)
+					{
+						if (_pairs[_members[p]].first == _pairs[_members[m]].first)
+						{
+							throw std::invalid_argument{ "frozen_dualmap has a duplicate left value" };
+						};
+					};
+				};
+
+				for (uint64_t _seed = 1; ; ++_seed)
+				{
+					bool _fits = true;
+					for (size_t m = 0; m != _count && _fits; ++m)
+					{
+						_slots[m] = slot_of(_pairs[_members[m]].first, _seed);
+						_fits = !_taken[_slots[m]];
+						for (size_t p = 0; p != m && _fits; ++p)
+						{
+							_fits = _slots[p] != _slots[m];
+						};
+					};
+
+					if (_fits)
+					{
+						for (size_t m = 0; m != _count; ++m)
+						{
+							_taken[_slots[m]] = true;
+							this->by_left_[_slots[m]] = _pairs[_members[m]];
+						};
+						this->seeds_[_bucket] = _seed;
+						break;
+					};
+				};
+			};
+		};
+
+	public:
+		constexpr const_iterator begin() const noexcept { return this->by_right_.cbegin(); };
+		constexpr const_iterator end() const noexcept { return this->by_right_.cend(); };
+
+		constexpr size_type size() const noexcept { return N; };
+		constexpr bool empty() const noexcept { return false; };
+
+		constexpr const right_type& ltor(left_type _l) const
+		{
+			const auto _pair = this->find_left_pair(_l);
+			if (!_pair)
+			{
+				throw std::out_of_range{ "frozen_dualmap::ltor" };
+			};
+			return _pair->second;
+		};
+		constexpr const left_type& rtol(const right_type& _r) const
+		{
+			const auto _pair = this->find_right_pair(_r);
+			if (!_pair)
+			{
+				throw std::out_of_range{ "frozen_dualmap::rtol" };
+			};
+			return _pair->first;
+		};
+
+		constexpr std::optional<std::reference_wrapper<const right_type>> find_left(left_type _l) const noexcept
+		{
+			const auto _pair = this->find_left_pair(_l);
+			return (_pair) ? std::optional{ std::cref(_pair->second) } : std::nullopt;
+		};
+		constexpr std::optional<std::reference_wrapper<const left_type>> find_right(const right_type& _r) const noexcept
+		{
+			const auto _pair = this->find_right_pair(_r);
+			return (_pair) ? std::optional{ std::cref(_pair->first) } : std::nullopt;
+		};
+
+		constexpr bool contains_left(left_type _l) const noexcept
+		{
+			return this->find_left_pair(_l) != nullptr;
+		};
+		constexpr bool contains_right(const right_type& _r) const noexcept
+		{
+			return this->find_right_pair(_r) != nullptr;
+		};
+
+		constexpr explicit frozen_dualmap(const value_type(&_pairs)[N])
+		{
+			this->build_right(_pairs);
+			this->build_left(_pairs);
+		};
+
+	private:
+		container_type by_left_{};
+		container_type by_right_{};
+		std::array<uint64_t, N> seeds_{};
+
+	};
+
+	/**
+	 * @brief Empty frozen_dualmap, there is no zero length array to build one from so it is default constructed
+	 * and every lookup misses
+	*/
+	template <typename RT>
+	class frozen_dualmap<RT, 0>
+	{
+	public:
+		using left_type = std::string_view;
+		using right_type = RT;
+		using value_type = std::pair<left_type, right_type>;
+		using size_type = size_t;
+
+		using container_type = std::array<value_type, 0>;
+		using const_iterator = typename container_type::const_iterator;
+		using iterator = const_iterator;
+
+		constexpr const_iterator begin() const noexcept { return this->pairs_.cbegin(); };
+		constexpr const_iterator end() const noexcept { return this->pairs_.cend(); };
+
+		constexpr size_type size() const noexcept { return 0; };
+		constexpr bool empty() const noexcept { return true; };
+
+		constexpr const right_type& ltor(left_type) const
+		{
+			throw std::out_of_range{ "frozen_dualmap::ltor" };
+		};
+		constexpr const left_type& rtol(const right_type&) const
+		{
+			throw std::out_of_range{ "frozen_dualmap::rtol" };
+		};
+
+		constexpr std::optional<std::reference_wrapper<const right_type>> find_left(left_type) const noexcept
+		{
+			return std::nullopt;
+		};
+		constexpr std::optional<std::reference_wrapper<const left_type>> find_right(const right_type&) const noexcept
+		{
+			return std::nullopt;
+		};
+
+		constexpr bool contains_left(left_type) const noexcept { return false; };
+		constexpr bool contains_right(const right_type&) const noexcept { return false; };
+
+		constexpr frozen_dualmap() noexcept = default;
+
+	private:
+		container_type pairs_{};
+
+	};
+
+	/**
+	 * @brief Builds a frozen_dualmap, use with constexpr to do all of the work at compile time
+	 * 
+	 * @code
+	 * constexpr auto colors = sae::make_frozen_dualmap<color>({ { "red", color::red }, { "green", color::green } });
+	 * @endcode
+	*/
+	template <typename RT, size_t N>
+	constexpr frozen_dualmap<RT, N> make_frozen_dualmap(const std::pair<std::string_view, RT>(&_pairs)[N])
+	{
+		return frozen_dualmap<RT, N>{ _pairs };
+	};
+
+	/**
+	 * @brief Builds an empty frozen_dualmap, an empty braced list cannot deduce a zero length array
+	*/
+	template <typename RT>
+	constexpr frozen_dualmap<RT, 0> make_frozen_dualmap()
+	{
+		return frozen_dualmap<RT, 0>{};
+	};
+
+}
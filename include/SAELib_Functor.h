@@ -50,6 +50,8 @@
 	};
 */
 
+#include "SAELib_Memory.h"
+
 #include <type_traits>
 #include <utility>
 
@@ -86,6 +88,16 @@ namespace sae
 			{
 				return new freeFunctionPtr_t{ *this };
 			};
+
+			// Functors are copied often, keep their targets in a pool instead of the general heap
+			static void* operator new(size_t)
+			{
+				return object_pool<freeFunctionPtr_t>::allocate();
+			};
+			static void operator delete(void* _ptr) noexcept
+			{
+				object_pool<freeFunctionPtr_t>::deallocate(_ptr);
+			};
 			virtual inline ReturnT invoke(Args... args) const final
 			{
 				if constexpr (std::is_same<void, ReturnT>::value)
@@ -118,6 +130,15 @@ namespace sae
 			{
 				return new memberFunctionPtr_t{ *this };
 			};
+
+			static void* operator new(size_t)
+			{
+				return object_pool<memberFunctionPtr_t>::allocate();
+			};
+			static void operator delete(void* _ptr) noexcept
+			{
+				object_pool<memberFunctionPtr_t>::deallocate(_ptr);
+			};
 			virtual inline ReturnT invoke(Args... args) const final
 			{
 				if constexpr (std::is_same<void, ReturnT>::value)
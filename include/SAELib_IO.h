@@ -0,0 +1,927 @@
+#pragma once
+#ifndef SAELIB_IO_H
+#define SAELIB_IO_H
+
+/*
+	Batched file io.
+
+	Reads and writes are described as a batch of offset/buffer operations and submitted to an io_context
+	together. The context picks a backend when it is constructed :
+
+		io_backend::uring			Linux io_uring, the whole batch is submitted with a single syscall
+		io_backend::thread_pool		pread / pwrite spread over a shared pool of worker threads
+		io_backend::stream			std::fstream seek + read/write, used when the target is not posix
+
+	io_uring is used if the kernel supports its read and write opcodes (5.6 and newer), define SAELIB_IO_NO_URING
+	to always use the thread pool.
+*/
+
+#include "SAELib_OS.h"
+#include "SAELib_Stream.h"
+#include "SAELib_Singleton.h"
+#include "SAELib_Thread.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+#include <string_view>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <type_traits>
+
+#if defined(SAELIB_OS_LINUX) || defined(SAELIB_OS_UNIX) || defined(SAELIB_OS_MAC) || defined(SAELIB_OS_POSIX)
+#define SAELIB_IO_POSIX true
+#else
+#define SAELIB_IO_POSIX false
+#endif
+
+#if defined(SAELIB_OS_LINUX) && !defined(SAELIB_IO_NO_URING) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+
+// Headers older than 5.6 lack the read/write opcodes and probing used below
+#if defined(SAELIB_OS_LINUX) && !defined(SAELIB_IO_NO_URING) && defined(IORING_FEAT_RW_CUR_POS)
+#define SAELIB_IO_URING true
+#else
+#define SAELIB_IO_URING false
+#endif
+
+#if SAELIB_IO_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
+#endif
+
+#if SAELIB_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace sae
+{
+	enum class io_backend
+	{
+		uring,
+		thread_pool,
+		stream
+	};
+
+	// Number of operations an io_context keeps in flight at once
+	constexpr static unsigned IO_CONTEXT_DEPTH_V = 64;
+
+	// Number of workers in the thread pool backend
+	constexpr static size_t IO_THREAD_POOL_SIZE_V = 4;
+
+	/**
+	 * @brief Read of buffer.size() bytes starting at offset, result is set to the number of bytes read or -errno
+	*/
+	struct io_read_op
+	{
+		std::span<std::byte> buffer{};
+		uint64_t offset = 0;
+		int64_t result = 0;
+	};
+
+	// Write offset meaning the current end of the file, only valid for files opened with io_mode::append.
+	// Appends in the same batch may land in any order.
+	constexpr static uint64_t IO_APPEND_OFFSET_V = ~uint64_t{ 0 };
+
+	/**
+	 * @brief Write of buffer.size() bytes starting at offset, result is set to the number of bytes written or -errno
+	*/
+	struct io_write_op
+	{
+		std::span<const std::byte> buffer{};
+		uint64_t offset = 0;
+		int64_t result = 0;
+	};
+
+	enum class io_mode
+	{
+		read,
+		write,
+		append
+	};
+
+	class io_file
+	{
+	public:
+		bool is_open() const noexcept
+		{
+#if SAELIB_IO_POSIX
+			return this->fd_ >= 0;
+#else
+			return this->fstr_.is_open();
+#endif
+		};
+		explicit operator bool() const noexcept { return this->is_open(); };
+
+		/**
+		 * @brief Opens a file, io_mode::write truncates and io_mode::append keeps the existing contents
+		 * @return True if the file was opened
+		*/
+		bool open(const std::filesystem::path& _path, io_mode _mode = io_mode::read)
+		{
+			this->close();
+#if SAELIB_IO_POSIX
+			int _flags = O_CLOEXEC;
+			switch (_mode)
+			{
+			case io_mode::read:
+				_flags |= O_RDONLY;
+				break;
+			case io_mode::write:
+				_flags |= O_WRONLY | O_CREAT | O_TRUNC;
+				break;
+			case io_mode::append:
+				_flags |= O_WRONLY | O_CREAT | O_APPEND;
+				break;
+			};
+			this->fd_ = ::open(_path.c_str(), _flags, 0644);
+#else
+			std::ios::openmode _flags = std::ios::binary;
+			switch (_mode)
+			{
+			case io_mode::read:
+				_flags |= std::ios::in;
+				break;
+			case io_mode::write:
+				_flags |= std::ios::out | std::ios::trunc;
+				break;
+			case io_mode::append:
+				_flags |= std::ios::out | std::ios::in;
+				if (!std::filesystem::exists(_path))
+				{
+					std::ofstream{ _path };
+				};
+				break;
+			};
+			this->fstr_.open(_path, _flags);
+#endif
+			return this->is_open();
+		};
+		void close() noexcept
+		{
+#if SAELIB_IO_POSIX
+			if (this->is_open())
+			{
+				::close(this->fd_);
+				this->fd_ = -1;
+			};
+#else
+			if (this->is_open())
+			{
+				this->fstr_.close();
+			};
+#endif
+		};
+
+		/**
+		 * @brief Gets the current size of the file in bytes
+		*/
+		uint64_t size() const
+		{
+#if SAELIB_IO_POSIX
+			struct stat _st{};
+			if (::fstat(this->fd_, &_st) != 0)
+			{
+				return 0;
+			};
+			return (uint64_t)_st.st_size;
+#else
+			this->fstr_.seekg(0, std::ios::end);
+			return (uint64_t)this->fstr_.tellg();
+#endif
+		};
+
+#if SAELIB_IO_POSIX
+		int native_handle() const noexcept { return this->fd_; };
+#else
+		std::fstream& native_handle() const noexcept { return this->fstr_; };
+#endif
+
+		io_file() = default;
+		explicit io_file(const std::filesystem::path& _path, io_mode _mode = io_mode::read)
+		{
+			this->open(_path, _mode);
+		};
+
+		io_file(const io_file& other) = delete;
+		io_file& operator=(const io_file& other) = delete;
+
+		io_file(io_file&& other) noexcept :
+#if SAELIB_IO_POSIX
+			fd_{ std::exchange(other.fd_, -1) }
+#else
+			fstr_{ std::move(other.fstr_) }
+#endif
+		{};
+		io_file& operator=(io_file&& other) noexcept
+		{
+			this->close();
+#if SAELIB_IO_POSIX
+			this->fd_ = std::exchange(other.fd_, -1);
+#else
+			this->fstr_ = std::move(other.fstr_);
+#endif
+			return *this;
+		};
+
+		~io_file()
+		{
+			this->close();
+		};
+
+	private:
+#if SAELIB_IO_POSIX
+		int fd_ = -1;
+#else
+		mutable std::fstream fstr_{};
+#endif
+	};
+
+	namespace impl
+	{
+		/**
+		 * @brief Fixed set of workers that run the indices of a batch in parallel, the submitting thread joins in
+		*/
+		class io_thread_pool
+		{
+		public:
+			void run(size_t _count, const std::function<void(size_t)>& _op)
+			{
+				if (_count <= 1 || this->workers_.empty())
+				{
+					for (size_t n = 0; n != _count; ++n)
+					{
+						std::invoke(_op, n);
+					};
+					return;
+				};
+
+				std::unique_lock<std::mutex> _runLck{ this->run_mtx_ };
+
+				std::unique_lock<std::mutex> _lck{ this->mtx_ };
+				this->op_ = &_op;
+				this->count_ = _count;
+				this->next_ = 0;
+				this->pending_ = _count;
+				++this->generation_;
+				_lck.unlock();
+				this->cv_.notify_all();
+
+				this->work(_op, _count);
+
+				_lck.lock();
+				this->done_cv_.wait(_lck, [this]() { return this->pending_ == 0 && this->active_ == 0; });
+				this->op_ = nullptr;
+			};
+
+			explicit io_thread_pool(size_t _workers = IO_THREAD_POOL_SIZE_V)
+			{
+				this->workers_.reserve(_workers);
+				for (size_t n = 0; n != _workers; ++n)
+				{
+					this->workers_.emplace_back(&io_thread_pool::worker_main, this);
+				};
+			};
+
+			io_thread_pool(const io_thread_pool& other) = delete;
+			io_thread_pool& operator=(const io_thread_pool& other) = delete;
+
+			~io_thread_pool()
+			{
+				this->mtx_.lock();
+				this->stop_ = true;
+				this->mtx_.unlock();
+				this->cv_.notify_all();
+				this->workers_.clear();
+			};
+
+		private:
+			void work(const std::function<void(size_t)>& _op, size_t _count)
+			{
+				size_t _index = 0;
+				while ((_index = this->next_.fetch_add(1)) < _count)
+				{
+					std::invoke(_op, _index);
+					if (this->pending_.fetch_sub(1) == 1)
+					{
+						this->mtx_.lock();
+						this->mtx_.unlock();
+						this->done_cv_.notify_all();
+					};
+				};
+			};
+
+			void worker_main()
+			{
+				uint64_t _generation = 0;
+				std::unique_lock<std::mutex> _lck{ this->mtx_ };
+				while (true)
+				{
+					this->cv_.wait(_lck, [this, &_generation]() { return this->stop_ || (this->op_ && this->generation_ != _generation); });
+					if (this->stop_)
+					{
+						break;
+					};
+					_generation = this->generation_;
+
+					auto _op = this->op_;
+					const auto _count = this->count_;
+					++this->active_;
+					_lck.unlock();
+
+					this->work(*_op, _count);
+
+					_lck.lock();
+					--this->active_;
+					this->done_cv_.notify_all();
+				};
+			};
+
+			std::mutex run_mtx_{};
+
+			std::mutex mtx_{};
+			std::condition_variable cv_{};
+			std::condition_variable done_cv_{};
+
+			const std::function<void(size_t)>* op_ = nullptr;
+			size_t count_ = 0;
+			uint64_t generation_ = 0;
+			size_t active_ = 0;
+			bool stop_ = false;
+
+			std::atomic<size_t> next_{ 0 };
+			std::atomic<size_t> pending_{ 0 };
+
+			// Must be last so the pool is fully constructed before the workers start
+			std::vector<thread> workers_{};
+		};
+
+		struct SAELib_IO_H_ThreadPoolSingletonTag {};
+
+		// Inline so every translation unit shares the one pool
+		inline io_thread_pool& shared_io_thread_pool()
+		{
+			return get_singleton<io_thread_pool, SAELib_IO_H_ThreadPoolSingletonTag>();
+		};
+
+#if SAELIB_IO_URING
+		class io_uring_ring
+		{
+		public:
+			bool good() const noexcept { return this->fd_ >= 0; };
+
+			/**
+			 * @brief Submits _count operations and waits for all of them to complete
+			 * @param _prep Called with (io_uring_sqe&, index) to fill in each submission
+			 * @param _complete Called with (index, result) for each completion
+			*/
+			template <typename PrepT, typename CompleteT>
+			void run(size_t _count, PrepT&& _prep, CompleteT&& _complete)
+			{
+				size_t _next = 0;
+				size_t _done = 0;
+				std::vector<bool> _completed(_count, false);
+
+				while (_done != _count)
+				{
+					auto _sqTail = *this->sq_tail_;
+					while (_next != _count && (_next - _done) < this->sq_entries_)
+					{
+						const auto _index = _sqTail & this->sq_mask_;
+						auto& _sqe = this->sqes_[_index];
+						std::memset(&_sqe, 0, sizeof(_sqe));
+						std::invoke(_prep, _sqe, _next);
+						_sqe.user_data = (uint64_t)_next;
+						this->sq_array_[_index] = _index;
+						++_sqTail;
+						++_next;
+					};
+					std::atomic_ref<unsigned>{ *this->sq_tail_ }.store(_sqTail, std::memory_order_release);
+
+					// Includes anything left over from an interrupted submit
+					const auto _submit = _sqTail - std::atomic_ref<unsigned>{ *this->sq_head_ }.load(std::memory_order_acquire);
+
+					const auto _res = ::syscall(__NR_io_uring_enter, this->fd_, _submit, 1u, IORING_ENTER_GETEVENTS, nullptr, 0);
+					if (_res < 0 && errno != EINTR && errno != EAGAIN)
+					{
+						// Ring is unusable, fail the rest of the batch and let the context fall back
+						const auto _err = -(int64_t)errno;
+						this->reset();
+						for (size_t n = 0; n != _count; ++n)
+						{
+							if (!_completed[n])
+							{
+								std::invoke(_complete, n, _err);
+							};
+						};
+						return;
+					};
+
+					auto _cqHead = *this->cq_head_;
+					const auto _cqTail = std::atomic_ref<unsigned>{ *this->cq_tail_ }.load(std::memory_order_acquire);
+					for (; _cqHead != _cqTail; ++_cqHead)
+					{
+						const auto& _cqe = this->cqes_[_cqHead & this->cq_mask_];
+						_completed[(size_t)_cqe.user_data] = true;
+						std::invoke(_complete, (size_t)_cqe.user_data, (int64_t)_cqe.res);
+						++_done;
+					};
+					std::atomic_ref<unsigned>{ *this->cq_head_ }.store(_cqHead, std::memory_order_release);
+				};
+			};
+
+			explicit io_uring_ring(unsigned _entries = IO_CONTEXT_DEPTH_V)
+			{
+				io_uring_params _params{};
+				const auto _fd = (int)::syscall(__NR_io_uring_setup, _entries, &_params);
+				if (_fd < 0)
+				{
+					return;
+				};
+				this->fd_ = _fd;
+
+				if ((_params.features & IORING_FEAT_RW_CUR_POS) == 0 || !this->supports_read_write())
+				{
+					// Kernels before 5.6 can set up a ring but fail every read and write with -EINVAL
+					this->reset();
+					return;
+				};
+
+				this->sq_size_ = _params.sq_off.array + _params.sq_entries * sizeof(unsigned);
+				this->cq_size_ = _params.cq_off.cqes + _params.cq_entries * sizeof(io_uring_cqe);
+				const bool _singleMap = (_params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+				if (_singleMap)
+				{
+					this->sq_size_ = std::max(this->sq_size_, this->cq_size_);
+					this->cq_size_ = this->sq_size_;
+				};
+
+				this->sq_ptr_ = ::mmap(nullptr, this->sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd_, IORING_OFF_SQ_RING);
+				if (this->sq_ptr_ == MAP_FAILED)
+				{
+					this->sq_ptr_ = nullptr;
+					this->reset();
+					return;
+				};
+				this->cq_ptr_ = (_singleMap) ? this->sq_ptr_ :
+					::mmap(nullptr, this->cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd_, IORING_OFF_CQ_RING);
+				if (this->cq_ptr_ == MAP_FAILED)
+				{
+					this->cq_ptr_ = nullptr;
+					this->reset();
+					return;
+				};
+
+				this->sqes_size_ = _params.sq_entries * sizeof(io_uring_sqe);
+				auto _sqes = ::mmap(nullptr, this->sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd_, IORING_OFF_SQES);
+				if (_sqes == MAP_FAILED)
+				{
+					this->reset();
+					return;
+				};
+				this->sqes_ = (io_uring_sqe*)_sqes;
+
+				auto _sq = (std::byte*)this->sq_ptr_;
+				this->sq_head_ = (unsigned*)(_sq + _params.sq_off.head);
+				this->sq_tail_ = (unsigned*)(_sq + _params.sq_off.tail);
+				this->sq_mask_ = *(unsigned*)(_sq + _params.sq_off.ring_mask);
+				this->sq_array_ = (unsigned*)(_sq + _params.sq_off.array);
+				this->sq_entries_ = _params.sq_entries;
+
+				auto _cq = (std::byte*)this->cq_ptr_;
+				this->cq_head_ = (unsigned*)(_cq + _params.cq_off.head);
+				this->cq_tail_ = (unsigned*)(_cq + _params.cq_off.tail);
+				this->cq_mask_ = *(unsigned*)(_cq + _params.cq_off.ring_mask);
+				this->cqes_ = (io_uring_cqe*)(_cq + _params.cq_off.cqes);
+			};
+
+			io_uring_ring(const io_uring_ring& other) = delete;
+			io_uring_ring& operator=(const io_uring_ring& other) = delete;
+
+			~io_uring_ring()
+			{
+				this->reset();
+			};
+
+		private:
+			bool supports_read_write() const
+			{
+				constexpr size_t _opCount = 256;
+				std::vector<std::byte> _storage(sizeof(io_uring_probe) + _opCount * sizeof(io_uring_probe_op));
+				auto _probe = (io_uring_probe*)_storage.data();
+				if (::syscall(__NR_io_uring_register, this->fd_, IORING_REGISTER_PROBE, _probe, (unsigned)_opCount) < 0)
+				{
+					return false;
+				};
+
+				const auto _supported = [_probe](unsigned _op)
+				{
+					return _op <= _probe->last_op && (_probe->ops[_op].flags & IO_URING_OP_SUPPORTED) != 0;
+				};
+				return _supported(IORING_OP_READ) && _supported(IORING_OP_WRITE);
+			};
+
+			void reset() noexcept
+			{
+				if (this->sqes_)
+				{
+					::munmap(this->sqes_, this->sqes_size_);
+					this->sqes_ = nullptr;
+				};
+				if (this->cq_ptr_ && this->cq_ptr_ != this->sq_ptr_)
+				{
+					::munmap(this->cq_ptr_, this->cq_size_);
+				};
+				this->cq_ptr_ = nullptr;
+				if (this->sq_ptr_)
+				{
+					::munmap(this->sq_ptr_, this->sq_size_);
+					this->sq_ptr_ = nullptr;
+				};
+				if (this->fd_ >= 0)
+				{
+					::close(this->fd_);
+					this->fd_ = -1;
+				};
+			};
+
+			int fd_ = -1;
+
+			void* sq_ptr_ = nullptr;
+			void* cq_ptr_ = nullptr;
+			size_t sq_size_ = 0;
+			size_t cq_size_ = 0;
+			size_t sqes_size_ = 0;
+
+			io_uring_sqe* sqes_ = nullptr;
+			unsigned* sq_head_ = nullptr;
+			unsigned* sq_tail_ = nullptr;
+			unsigned* sq_array_ = nullptr;
+			unsigned sq_mask_ = 0;
+			unsigned sq_entries_ = 0;
+
+			unsigned* cq_head_ = nullptr;
+			unsigned* cq_tail_ = nullptr;
+			unsigned cq_mask_ = 0;
+			io_uring_cqe* cqes_ = nullptr;
+		};
+#endif
+	};
+
+	class io_context
+	{
+	public:
+		io_backend backend() const noexcept
+		{
+#if SAELIB_IO_URING
+			if (this->ring_.good())
+			{
+				return io_backend::uring;
+			};
+#endif
+			return (SAELIB_IO_POSIX) ? io_backend::thread_pool : io_backend::stream;
+		};
+
+		/**
+		 * @brief Submits a batch of reads and waits for all of them to complete
+		*/
+		void read(const io_file& _file, std::span<io_read_op> _ops)
+		{
+#if SAELIB_IO_URING
+			if (this->ring_.good())
+			{
+				this->ring_.run(_ops.size(),
+					[&_file, &_ops](io_uring_sqe& _sqe, size_t _index)
+					{
+						const auto& _op = _ops[_index];
+						_sqe.opcode = IORING_OP_READ;
+						_sqe.fd = _file.native_handle();
+						_sqe.addr = (uint64_t)_op.buffer.data();
+						_sqe.len = (uint32_t)_op.buffer.size();
+						_sqe.off = _op.offset;
+					},
+					[&_ops](size_t _index, int64_t _result)
+					{
+						_ops[_index].result = _result;
+					});
+				return;
+			};
+#endif
+#if SAELIB_IO_POSIX
+			const auto _readOne = [&_file](io_read_op& _op)
+				{
+					const auto _res = ::pread(_file.native_handle(), _op.buffer.data(), _op.buffer.size(), (off_t)_op.offset);
+					_op.result = (_res < 0) ? -(int64_t)errno : (int64_t)_res;
+				};
+			if (_ops.size() == 1)
+			{
+				// Nothing to overlap, and keeps single reads working without the shared pool
+				_readOne(_ops.front());
+				return;
+			};
+			impl::shared_io_thread_pool().run(_ops.size(), [&_readOne, &_ops](size_t _index)
+				{
+					_readOne(_ops[_index]);
+				});
+#else
+			auto& _fstr = _file.native_handle();
+			for (auto& _op : _ops)
+			{
+				_fstr.clear();
+				_fstr.seekg((std::streamoff)_op.offset);
+				_fstr.read((char*)_op.buffer.data(), (std::streamsize)_op.buffer.size());
+				_op.result = (int64_t)_fstr.gcount();
+			};
+#endif
+		};
+
+		/**
+		 * @brief Submits a batch of writes and waits for all of them to complete
+		*/
+		void write(const io_file& _file, std::span<io_write_op> _ops)
+		{
+#if SAELIB_IO_URING
+			if (this->ring_.good())
+			{
+				this->ring_.run(_ops.size(),
+					[&_file, &_ops](io_uring_sqe& _sqe, size_t _index)
+					{
+						const auto& _op = _ops[_index];
+						_sqe.opcode = IORING_OP_WRITE;
+						_sqe.fd = _file.native_handle();
+						_sqe.addr = (uint64_t)_op.buffer.data();
+						_sqe.len = (uint32_t)_op.buffer.size();
+						_sqe.off = _op.offset;
+					},
+					[&_ops](size_t _index, int64_t _result)
+					{
+						_ops[_index].result = _result;
+					});
+				return;
+			};
+#endif
+#if SAELIB_IO_POSIX
+			const auto _writeOne = [&_file](io_write_op& _op)
+				{
+					const auto _res = (_op.offset == IO_APPEND_OFFSET_V) ?
+						::write(_file.native_handle(), _op.buffer.data(), _op.buffer.size()) :
+						::pwrite(_file.native_handle(), _op.buffer.data(), _op.buffer.size(), (off_t)_op.offset);
+					_op.result = (_res < 0) ? -(int64_t)errno : (int64_t)_res;
+				};
+			if (_ops.size() == 1)
+			{
+				// Done on the calling thread so io_file_writer's flush never touches the shared pool, which a
+				// static writer could outlive
+				_writeOne(_ops.front());
+				return;
+			};
+			impl::shared_io_thread_pool().run(_ops.size(), [&_writeOne, &_ops](size_t _index)
+				{
+					_writeOne(_ops[_index]);
+				});
+#else
+			auto& _fstr = _file.native_handle();
+			for (auto& _op : _ops)
+			{
+				_fstr.clear();
+				if (_op.offset == IO_APPEND_OFFSET_V)
+				{
+					_fstr.seekp(0, std::ios::end);
+				}
+				else
+				{
+					_fstr.seekp((std::streamoff)_op.offset);
+				};
+				_fstr.write((const char*)_op.buffer.data(), (std::streamsize)_op.buffer.size());
+				_op.result = (_fstr) ? (int64_t)_op.buffer.size() : -1;
+			};
+#endif
+		};
+
+		io_context([[maybe_unused]] unsigned _depth = IO_CONTEXT_DEPTH_V)
+#if SAELIB_IO_URING
+			: ring_{ _depth }
+#endif
+		{};
+
+		io_context(const io_context& other) = delete;
+		io_context& operator=(const io_context& other) = delete;
+
+	private:
+#if SAELIB_IO_URING
+		impl::io_uring_ring ring_;
+#endif
+	};
+
+	namespace impl
+	{
+		struct SAELib_IO_H_ContextSingletonTag {};
+	};
+
+	/**
+	 * @brief Gets the io_context for the calling thread
+	*/
+	static io_context& get_io_context()
+	{
+		return get_singleton_thread_local<io_context, impl::SAELib_IO_H_ContextSingletonTag>();
+	};
+
+
+
+	// Size of each read submitted when draining a file
+	constexpr static size_t IO_DRAIN_CHUNK_SIZE_V = 1024 * 1024;
+
+	/**
+	 * @brief Reads an entire file, splitting it into a batch of reads submitted together
+	 * @return File contents, or an empty vector if the file could not be read
+	*/
+	template <typename T = std::byte> requires std::is_trivially_copy_assignable_v<T>
+	static std::vector<T> drain(const std::filesystem::path& _path, io_context& _context = get_io_context())
+	{
+		std::error_code _ec{};
+		if (!std::filesystem::is_regular_file(_path, _ec))
+		{
+			// Pipes and devices have no size to split up
+			std::ifstream _ifstr{ _path, std::ios::binary };
+			if (!_ifstr)
+			{
+				return std::vector<T>{};
+			};
+			return drain<T>(_ifstr);
+		};
+
+		io_file _file{ _path, io_mode::read };
+		if (!_file)
+		{
+			return std::vector<T>{};
+		};
+
+		const auto _fileSize = (size_t)_file.size();
+		std::vector<T> _out(_fileSize / sizeof(T));
+		auto _bytes = std::as_writable_bytes(std::span<T>{ _out });
+
+		std::vector<io_read_op> _ops{};
+		_ops.reserve((_bytes.size() + IO_DRAIN_CHUNK_SIZE_V - 1) / IO_DRAIN_CHUNK_SIZE_V);
+		for (size_t _offset = 0; _offset < _bytes.size(); _offset += IO_DRAIN_CHUNK_SIZE_V)
+		{
+			io_read_op _op{};
+			_op.buffer = _bytes.subspan(_offset, std::min(IO_DRAIN_CHUNK_SIZE_V, _bytes.size() - _offset));
+			_op.offset = _offset;
+			_ops.push_back(_op);
+		};
+
+		// Resubmit short reads until every chunk is full or hits the end of the file
+		auto _pending = std::span<io_read_op>{ _ops };
+		while (!_pending.empty())
+		{
+			_context.read(_file, _pending);
+
+			auto _last = std::remove_if(_pending.begin(), _pending.end(), [](io_read_op& _op)
+				{
+					if (_op.result <= 0)
+					{
+						return true;
+					};
+					_op.buffer = _op.buffer.subspan((size_t)_op.result);
+					_op.offset += (uint64_t)_op.result;
+					return _op.buffer.empty();
+				});
+			_pending = _pending.first((size_t)std::distance(_pending.begin(), _last));
+		};
+
+		// Anything not read (file shrank or an error) is cut off at the first gap
+		size_t _readBytes = _bytes.size();
+		for (const auto& _op : _ops)
+		{
+			if (!_op.buffer.empty())
+			{
+				_readBytes = std::min<size_t>(_readBytes, (size_t)(_op.offset));
+			};
+		};
+		_out.resize(_readBytes / sizeof(T));
+
+		return _out;
+	};
+
+
+
+	// Bytes buffered by an io_file_writer before they are written out
+	constexpr static size_t IO_WRITER_BUFFER_SIZE_V = 64 * 1024;
+
+	/**
+	 * @brief Appends to a file through an io_context, buffering writes so many small writes become one
+	 *
+	 * Not thread safe, but may be used from any thread as long as calls are not concurrent.
+	*/
+	class io_file_writer
+	{
+	public:
+		bool is_open() const noexcept { return this->file_.is_open(); };
+		explicit operator bool() const noexcept { return this->is_open(); };
+
+		bool open(const std::filesystem::path& _path, io_mode _mode = io_mode::append)
+		{
+			this->close();
+			this->file_.open(_path, _mode);
+			this->offset_ = (_mode == io_mode::append) ? IO_APPEND_OFFSET_V : 0;
+			return this->is_open();
+		};
+		void close()
+		{
+			if (this->is_open())
+			{
+				this->flush();
+				this->file_.close();
+			};
+		};
+
+		void write(std::string_view _str)
+		{
+			const auto _bytes = std::as_bytes(std::span<const char>{ _str.data(), _str.size() });
+			if (this->buffer_.size() + _bytes.size() > this->buffer_size_)
+			{
+				this->flush();
+			};
+			this->buffer_.insert(this->buffer_.end(), _bytes.begin(), _bytes.end());
+			if (this->buffer_.size() >= this->buffer_size_)
+			{
+				this->flush();
+			};
+		};
+
+		/**
+		 * @brief Writes out anything that has been buffered
+		 * @return True if everything was written, otherwise the rest is kept and retried on the next flush
+		*/
+		bool flush()
+		{
+			std::span<const std::byte> _pending{ this->buffer_ };
+			while (!_pending.empty() && this->is_open())
+			{
+				io_write_op _op{};
+				_op.buffer = _pending;
+				_op.offset = this->offset_;
+				this->context_.write(this->file_, std::span<io_write_op>{ &_op, 1 });
+				if (_op.result <= 0)
+				{
+					break;
+				};
+				if (this->offset_ != IO_APPEND_OFFSET_V)
+				{
+					this->offset_ += (uint64_t)_op.result;
+				};
+				_pending = _pending.subspan((size_t)_op.result);
+			};
+
+			// Anything that failed to write stays buffered for the next flush
+			this->buffer_.erase(this->buffer_.begin(), this->buffer_.end() - (std::ptrdiff_t)_pending.size());
+			return _pending.empty();
+		};
+
+		explicit io_file_writer(size_t _bufferSize = IO_WRITER_BUFFER_SIZE_V) :
+			buffer_size_{ _bufferSize }
+		{
+			this->buffer_.reserve(this->buffer_size_);
+		};
+		explicit io_file_writer(const std::filesystem::path& _path, io_mode _mode = io_mode::append) :
+			io_file_writer{}
+		{
+			this->open(_path, _mode);
+		};
+
+		io_file_writer(const io_file_writer& other) = delete;
+		io_file_writer& operator=(const io_file_writer& other) = delete;
+
+		~io_file_writer()
+		{
+			this->close();
+		};
+
+	private:
+		// Owned rather than the thread's get_io_context() so the writer can outlive the thread that made it and
+		// be used from others, only one write is ever in flight so the shared thread pool is never used and a
+		// static writer can still flush after the pool has been destroyed
+		io_context context_{ 1 };
+		size_t buffer_size_;
+		std::vector<std::byte> buffer_{};
+
+		io_file file_{};
+
+		// Where the next write goes, IO_APPEND_OFFSET_V when appending so other writers to the file are not overwritten
+		uint64_t offset_ = 0;
+	};
+
+};
+
+#endif
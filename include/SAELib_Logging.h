@@ -1,10 +1,12 @@
 #pragma once
 
 #include "SAELib_Concepts.h"
+#include "SAELib_IO.h"
 
 #include <ostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <atomic>
 #include <concepts>
 #include <filesystem>
@@ -64,6 +66,14 @@ namespace sae
 		static inline std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
 	};
 
+	/**
+	 * @brief Appends log entries to a file
+	 *
+	 * By default every entry is written out when its endentry is logged, so nothing already logged is lost if
+	 * the process dies. With batching enabled entries are kept in a buffer and written out together when it
+	 * fills, on flush() or on close(), which is much cheaper for chatty logs but loses whatever is still
+	 * buffered on a crash.
+	*/
 	struct file_logger
 	{
 	public:
@@ -72,33 +82,58 @@ namespace sae
 			return this->path_;
 		};
 
-		file_logger& log(const log_message_t& _message)
+		bool is_batched() const noexcept { return this->batched_; };
+
+		/**
+		 * @brief Sets whether entries are buffered instead of written out as each one ends, turning batching
+		 * off writes out anything still buffered
+		*/
+		void set_batched(bool _batched)
+		{
+			this->batched_ = _batched;
+			if (!this->batched_)
+			{
+				this->flush();
+			};
+		};
+
+		// Takes a view so messages built in arena or pmr backed strings can be logged without a copy
+		file_logger& log(std::string_view _message)
 		{
-			this->ofstr_ << _message;
+			this->writer_.write(_message);
 			return *this;
 		};
 		file_logger& log(endentry_t)
 		{
-			this->ofstr_ << std::endl;
+			this->writer_.write("\n");
+			if (!this->batched_)
+			{
+				this->writer_.flush();
+			};
 			return *this;
 		};
 
+		void flush()
+		{
+			this->writer_.flush();
+		};
+
 		bool is_open() const
 		{
-			return this->ofstr_.is_open();
+			return this->writer_.is_open();
 		};
 		explicit operator bool() const { return this->is_open(); };
 
 		void close()
 		{
-			if (this->ofstr_.is_open())
-				this->ofstr_.close();
+			if (this->writer_.is_open())
+				this->writer_.close();
 		};
 		void open(const std::filesystem::path& _path)
 		{
 			this->close();
 			this->path_ = _path;
-			this->ofstr_.open(this->path(), std::ios::ate | std::ios::app);
+			this->writer_.open(this->path(), io_mode::append);
 			this->log("LOG BEGIN").log(endentry);
 		};
 		void clear()
@@ -107,14 +142,15 @@ namespace sae
 			this->close();
 			std::filesystem::remove(this->path());
 			if (_o)
-				this->ofstr_.open(this->path(), std::ios::ate | std::ios::app);
+				this->writer_.open(this->path(), io_mode::append);
 		};
 
 		file_logger& operator<<(const log_entry& _entry)
 		{
-			return this->log(basic_log_formatter{}.format(_entry));
+			// Same layout as basic_log_formatter written piecewise into the buffer instead of a temporary string
+			return this->log("(").log(_entry.level).log(")[").log(_entry.source).log("] ").log(_entry.message);
 		};
-		file_logger& operator<<(const log_message_t& _msg)
+		file_logger& operator<<(std::string_view _msg)
 		{
 			return this->log(_msg);
 		};
@@ -124,8 +160,8 @@ namespace sae
 		};
 
 		file_logger() = default;
-		file_logger(const std::filesystem::path& _path) : 
-			path_{ (_path.is_relative())? _path : std::filesystem::relative(_path) }
+		file_logger(const std::filesystem::path& _path, bool _batched = false) : 
+			path_{ (_path.is_relative())? _path : std::filesystem::relative(_path) }, batched_{ _batched }
 		{
 			this->open(this->path());
 		};
@@ -137,7 +173,8 @@ namespace sae
 
 	private:
 		std::filesystem::path path_{};
-		std::ofstream ofstr_{};
+		bool batched_ = false;
+		io_file_writer writer_{};
 	};
 	
 }
\ No newline at end of file
@@ -2,9 +2,22 @@
 #ifndef SAELIB_MEMORY_H
 #define SAELIB_MEMORY_H
 
+#include "SAELib_Singleton.h"
+
 #include <memory>
+#include <memory_resource>
 #include <concepts>
 #include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <compare>
+#include <functional>
 
 namespace sae
 {
@@ -34,6 +47,733 @@ namespace sae
 	{
 		return std::make_shared<T>( std::forward<Ts>(_cargs)... );
 	};
+
+
+
+	/**
+	 * @brief Reference count policy for objects shared between threads
+	*/
+	struct atomic_ref_count
+	{
+		using count_type = std::atomic<uint32_t>;
+
+		static void increment(count_type& _count) noexcept
+		{
+			_count.fetch_add(1, std::memory_order_relaxed);
+		};
+		// Release so writes happen before the delete, acquire on the last reference so the delete sees them
+		static bool decrement(count_type& _count) noexcept
+		{
+			return _count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+		};
+		static uint32_t load(const count_type& _count) noexcept
+		{
+			return _count.load(std::memory_order_relaxed);
+		};
+	};
+
+	/**
+	 * @brief Reference count policy for objects that never leave one thread, counting is a plain increment
+	*/
+	struct local_ref_count
+	{
+		using count_type = uint32_t;
+
+		static void increment(count_type& _count) noexcept
+		{
+			++_count;
+		};
+		static bool decrement(count_type& _count) noexcept
+		{
+			return --_count == 0;
+		};
+		static uint32_t load(const count_type& _count) noexcept
+		{
+			return _count;
+		};
+	};
+
+	/**
+	 * @brief CRTP base that stores the reference count inside the object for intrusive_ptr
+	 * 
+	 * Copying an object does not copy its count. The object is deleted through T* when the last
+	 * intrusive_ptr goes away, so T does not need a virtual destructor.
+	 * 
+	 * @tparam PolicyT atomic_ref_count or local_ref_count
+	*/
+	template <typename T, typename PolicyT = atomic_ref_count>
+	class ref_counted
+	{
+	public:
+		using ref_count_policy = PolicyT;
+
+		uint32_t use_count() const noexcept
+		{
+			return PolicyT::load(this->ref_count_);
+		};
+
+		friend void intrusive_ptr_add_ref(const ref_counted* _ptr) noexcept
+		{
+			PolicyT::increment(_ptr->ref_count_);
+		};
+		friend void intrusive_ptr_release(const ref_counted* _ptr) noexcept
+		{
+			if (PolicyT::decrement(_ptr->ref_count_))
+			{
+				delete static_cast<const T*>(_ptr);
+			};
+		};
+
+	protected:
+		ref_counted() noexcept = default;
+		ref_counted(const ref_counted&) noexcept {};
+		ref_counted& operator=(const ref_counted&) noexcept { return *this; };
+		~ref_counted() = default;
+
+	private:
+		mutable typename PolicyT::count_type ref_count_{ 0 };
+
+	};
+
+	/**
+	 * @brief Shared pointer to an object that carries its own reference count
+	 * 
+	 * The pointer is a single T*, copies touch only the count inside the object, and there is no separate control
+	 * block. Counting is done through intrusive_ptr_add_ref and intrusive_ptr_release found by ADL, which
+	 * ref_counted provides.
+	*/
+	template <typename T>
+	class intrusive_ptr
+	{
+	public:
+		using element_type = T;
+		using pointer = T*;
+
+		pointer get() const noexcept { return this->ptr_; };
+		T& operator*() const noexcept { return *this->ptr_; };
+		pointer operator->() const noexcept { return this->ptr_; };
+
+		explicit operator bool() const noexcept { return this->ptr_ != nullptr; };
+
+		void reset() noexcept
+		{
+			intrusive_ptr{}.swap(*this);
+		};
+		void reset(pointer _ptr, bool _addRef = true)
+		{
+			intrusive_ptr{ _ptr, _addRef }.swap(*this);
+		};
+
+		/**
+		 * @brief Gives up ownership without releasing the reference
+		*/
+		pointer detach() noexcept
+		{
+			return std::exchange(this->ptr_, nullptr);
+		};
+
+		void swap(intrusive_ptr& other) noexcept
+		{
+			std::swap(this->ptr_, other.ptr_);
+		};
+
+		template <typename U>
+		friend bool operator==(const intrusive_ptr& _lhs, const intrusive_ptr<U>& _rhs) noexcept
+		{
+			return _lhs.get() == _rhs.get();
+		};
+		friend bool operator==(const intrusive_ptr& _lhs, std::nullptr_t) noexcept
+		{
+			return _lhs.get() == nullptr;
+		};
+		friend auto operator<=>(const intrusive_ptr& _lhs, const intrusive_ptr& _rhs) noexcept
+		{
+			return std::compare_three_way{}(_lhs.get(), _rhs.get());
+		};
+
+		constexpr intrusive_ptr() noexcept = default;
+		constexpr intrusive_ptr(std::nullptr_t) noexcept {};
+
+		/**
+		 * @param _addRef False to adopt a reference that was already counted, such as one from detach()
+		*/
+		explicit intrusive_ptr(pointer _ptr, bool _addRef = true) :
+			ptr_{ _ptr }
+		{
+			if (this->ptr_ && _addRef)
+			{
+				intrusive_ptr_add_ref(this->ptr_);
+			};
+		};
+
+		intrusive_ptr(const intrusive_ptr& other) noexcept :
+			intrusive_ptr{ other.ptr_ }
+		{};
+		intrusive_ptr& operator=(const intrusive_ptr& other) noexcept
+		{
+			intrusive_ptr{ other }.swap(*this);
+			return *this;
+		};
+
+		intrusive_ptr(intrusive_ptr&& other) noexcept :
+			ptr_{ std::exchange(other.ptr_, nullptr) }
+		{};
+		intrusive_ptr& operator=(intrusive_ptr&& other) noexcept
+		{
+			intrusive_ptr{ std::move(other) }.swap(*this);
+			return *this;
+		};
+
+		template <typename U> requires std::convertible_to<U*, T*>
+		intrusive_ptr(const intrusive_ptr<U>& other) noexcept :
+			intrusive_ptr{ other.get() }
+		{};
+		template <typename U> requires std::convertible_to<U*, T*>
+		intrusive_ptr(intrusive_ptr<U>&& other) noexcept :
+			ptr_{ other.detach() }
+		{};
+
+		~intrusive_ptr()
+		{
+			if (this->ptr_)
+			{
+				intrusive_ptr_release(this->ptr_);
+			};
+		};
+
+	private:
+		pointer ptr_ = nullptr;
+
+	};
+
+	template <typename T, typename... Ts>
+	static intrusive_ptr<T> make_intrusive(Ts&&... _cargs)
+	{
+		return intrusive_ptr<T>{ new T(std::forward<Ts>(_cargs)...) };
+	};
+
+
+
+	constexpr static size_t ARENA_CHUNK_SIZE_V = 64 * 1024;
+
+	/**
+	 * @brief Bump allocator over a list of chunks, individual allocations are never freed
+	 * 
+	 * Allocating is a pointer bump in the current chunk. reset() rewinds to the first chunk and keeps the memory
+	 * so a batch of short lived objects can be thrown away at once and the next batch reuses the same chunks.
+	 * Destructors of objects placed in the arena are not run. Not thread safe.
+	*/
+	class arena
+	{
+	private:
+		struct chunk
+		{
+			std::byte* data;
+			size_t size;
+		};
+
+		void* bump(size_t _size, size_t _align) noexcept
+		{
+			const auto _aligned = ((uintptr_t)this->pos_ + (_align - 1)) & ~(uintptr_t)(_align - 1);
+			if (this->pos_ == nullptr || _aligned + _size > (uintptr_t)this->end_)
+			{
+				return nullptr;
+			};
+			this->pos_ = (std::byte*)(_aligned + _size);
+			return (void*)_aligned;
+		};
+
+		void next_chunk(size_t _minSize)
+		{
+			// Reuse chunks kept by reset() before asking for more memory
+			while (!this->chunks_.empty() && this->current_ + 1 < this->chunks_.size())
+			{
+				const auto& _chunk = this->chunks_[++this->current_];
+				if (_chunk.size >= _minSize)
+				{
+					this->pos_ = _chunk.data;
+					this->end_ = _chunk.data + _chunk.size;
+					return;
+				};
+			};
+
+			const auto _size = std::max(this->chunk_size_, _minSize);
+			const auto _data = (std::byte*)::operator new(_size);
+			this->chunks_.push_back(chunk{ _data, _size });
+			this->current_ = this->chunks_.size() - 1;
+			this->pos_ = _data;
+			this->end_ = _data + _size;
+			this->capacity_ += _size;
+		};
+
+	public:
+		/**
+		 * @brief Allocates _size bytes aligned to _align, which must be a power of two
+		*/
+		void* allocate(size_t _size, size_t _align = alignof(std::max_align_t))
+		{
+			_size = std::max<size_t>(_size, 1);
+			auto _ptr = this->bump(_size, _align);
+			if (!_ptr) [[unlikely]]
+			{
+				this->next_chunk(_size + _align);
+				_ptr = this->bump(_size, _align);
+			};
+			return _ptr;
+		};
+
+		/**
+		 * @brief Constructs an object in the arena, its destructor will not be called
+		*/
+		template <typename T, typename... Ts>
+		T* make(Ts&&... _args)
+		{
+			return new (this->allocate(sizeof(T), alignof(T))) T(std::forward<Ts>(_args)...);
+		};
+
+		/**
+		 * @brief Rewinds to the first chunk, everything allocated so far is invalidated but the memory is kept
+		*/
+		void reset() noexcept
+		{
+			this->current_ = 0;
+			if (this->chunks_.empty())
+			{
+				this->pos_ = nullptr;
+				this->end_ = nullptr;
+			}
+			else
+			{
+				this->pos_ = this->chunks_.front().data;
+				this->end_ = this->pos_ + this->chunks_.front().size;
+			};
+		};
+
+		/**
+		 * @brief Frees every chunk
+		*/
+		void release() noexcept
+		{
+			for (auto& _chunk : this->chunks_)
+			{
+				::operator delete(_chunk.data);
+			};
+			this->chunks_.clear();
+			this->capacity_ = 0;
+			this->reset();
+		};
+
+		size_t chunk_size() const noexcept { return this->chunk_size_; };
+		size_t capacity() const noexcept { return this->capacity_; };
+
+		explicit arena(size_t _chunkSize = ARENA_CHUNK_SIZE_V) :
+			chunk_size_{ _chunkSize }
+		{};
+
+		arena(const arena& other) = delete;
+		arena& operator=(const arena& other) = delete;
+
+		arena(arena&& other) noexcept :
+			chunks_{ std::move(other.chunks_) }, current_{ std::exchange(other.current_, 0) },
+			pos_{ std::exchange(other.pos_, nullptr) }, end_{ std::exchange(other.end_, nullptr) },
+			capacity_{ std::exchange(other.capacity_, 0) }, chunk_size_{ other.chunk_size_ }
+		{
+			other.chunks_.clear();
+		};
+		arena& operator=(arena&& other) noexcept
+		{
+			if (this != &other)
+			{
+				this->release();
+				this->chunks_ = std::move(other.chunks_);
+				other.chunks_.clear();
+				this->current_ = std::exchange(other.current_, 0);
+				this->pos_ = std::exchange(other.pos_, nullptr);
+				this->end_ = std::exchange(other.end_, nullptr);
+				this->capacity_ = std::exchange(other.capacity_, 0);
+				this->chunk_size_ = other.chunk_size_;
+			};
+			return *this;
+		};
+
+		~arena()
+		{
+			this->release();
+		};
+
+	private:
+		std::vector<chunk> chunks_{};
+		size_t current_ = 0;
+		std::byte* pos_ = nullptr;
+		std::byte* end_ = nullptr;
+		size_t capacity_ = 0;
+		size_t chunk_size_;
+
+	};
+
+	/**
+	 * @brief Exposes an arena as a std::pmr::memory_resource, deallocation is a no-op
+	*/
+	class arena_resource : public std::pmr::memory_resource
+	{
+	public:
+		arena& get_arena() const noexcept { return *this->arena_; };
+
+		explicit arena_resource(arena& _arena) noexcept :
+			arena_{ &_arena }
+		{};
+
+	private:
+		void* do_allocate(size_t _bytes, size_t _align) override
+		{
+			return this->arena_->allocate(_bytes, _align);
+		};
+		void do_deallocate(void*, size_t, size_t) override {};
+		bool do_is_equal(const std::pmr::memory_resource& _other) const noexcept override
+		{
+			const auto _otherArena = dynamic_cast<const arena_resource*>(&_other);
+			return _otherArena && _otherArena->arena_ == this->arena_;
+		};
+
+		arena* arena_;
+
+	};
+
+	/**
+	 * @brief Standard allocator that draws from an arena
+	 * 
+	 * Containers that grow leave their old buffers behind in the arena until it is reset, so reserve up front
+	 * where the final size is known.
+	*/
+	template <typename T>
+	class arena_allocator
+	{
+	public:
+		using value_type = T;
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		T* allocate(size_t _count)
+		{
+			if (_count > SIZE_MAX / sizeof(T))
+			{
+				throw std::bad_array_new_length{};
+			};
+			return static_cast<T*>(this->arena_->allocate(_count * sizeof(T), alignof(T)));
+		};
+		void deallocate(T*, size_t) noexcept {};
+
+		arena& get_arena() const noexcept { return *this->arena_; };
+
+		template <typename U>
+		friend bool operator==(const arena_allocator& _lhs, const arena_allocator<U>& _rhs) noexcept
+		{
+			return &_lhs.get_arena() == &_rhs.get_arena();
+		};
+
+		arena_allocator(arena& _arena) noexcept :
+			arena_{ &_arena }
+		{};
+		template <typename U>
+		arena_allocator(const arena_allocator<U>& other) noexcept :
+			arena_{ &other.get_arena() }
+		{};
+
+	private:
+		arena* arena_;
+
+	};
+
+
+
+	constexpr static size_t OBJECT_POOL_BATCH_SIZE_V = 64;
+
+	/**
+	 * @brief Fixed size allocator for T with a free list cache per thread
+	 * 
+	 * Each thread allocates from and frees into its own cache without locking. Caches trade slots with a shared
+	 * depot in batches of OBJECT_POOL_BATCH_SIZE_V, so memory freed on another thread comes back into circulation
+	 * and the depot lock is only taken once per batch. Free slots hold the list links, so each slot is at least
+	 * three pointers in size. Memory is never returned to the system. Frees that happen after the thread's cache
+	 * has been destroyed, such as from objects with static storage, go straight to the depot.
+	 * 
+	 * @tparam TagT Optional tag for keeping separate pools of the same type
+	*/
+	template <typename T, typename TagT = void>
+	class object_pool
+	{
+	private:
+		union slot;
+
+		// The first slot of a batch also links the batches together while they sit in the depot
+		struct slot_link
+		{
+			slot* next;
+			slot* next_batch;
+			size_t batch_count;
+		};
+
+		union slot
+		{
+			slot_link link;
+			alignas(T) std::byte storage[sizeof(T)];
+		};
+
+		struct depot
+		{
+			std::mutex mtx{};
+			slot* batches = nullptr;
+			std::vector<slot*> blocks{};
+
+			~depot()
+			{
+				for (auto _block : this->blocks)
+				{
+					delete[] _block;
+				};
+			};
+		};
+
+		static depot& get_depot()
+		{
+			// Never destroyed so objects with static storage can still free into it during program exit
+			static depot& _depot = *new depot{};
+			return _depot;
+		};
+
+		static void give(slot* _batch) noexcept
+		{
+			auto& _depot = get_depot();
+			std::unique_lock _lck{ _depot.mtx };
+			_batch->link.next_batch = _depot.batches;
+			_depot.batches = _batch;
+		};
+
+		enum class cache_state : uint8_t
+		{
+			none,
+			alive,
+			destroyed
+		};
+
+		// Trivially destructible so it can still be read after the thread's cache has been destroyed
+		static inline thread_local cache_state cache_state_ = cache_state::none;
+
+		struct cache
+		{
+			slot* head = nullptr;
+			size_t count = 0;
+
+			cache() noexcept
+			{
+				cache_state_ = cache_state::alive;
+			};
+
+			// Cuts the first _count slots off the free list
+			slot* take(size_t _count) noexcept
+			{
+				const auto _batch = this->head;
+				auto _last = this->head;
+				for (size_t n = 1; n < _count; ++n)
+				{
+					_last = _last->link.next;
+				};
+				this->head = _last->link.next;
+				_last->link.next = nullptr;
+				this->count -= _count;
+				_batch->link.batch_count = _count;
+				return _batch;
+			};
+
+			// Hand everything back when the thread exits so other threads can use it
+			~cache()
+			{
+				if (this->count != 0)
+				{
+					give(this->take(this->count));
+				};
+				cache_state_ = cache_state::destroyed;
+			};
+		};
+
+		static cache& get_cache()
+		{
+			return get_singleton_thread_local<cache, object_pool>();
+		};
+
+		static void refill(cache& _cache)
+		{
+			auto& _depot = get_depot();
+			{
+				std::unique_lock _lck{ _depot.mtx };
+				if (const auto _batch = _depot.batches; _batch)
+				{
+					_depot.batches = _batch->link.next_batch;
+					_cache.head = _batch;
+					_cache.count = _batch->link.batch_count;
+					return;
+				};
+			};
+
+			_cache.head = new_block();
+			_cache.count = OBJECT_POOL_BATCH_SIZE_V;
+		};
+
+		// Allocates OBJECT_POOL_BATCH_SIZE_V slots linked into a free list
+		static slot* new_block()
+		{
+			auto& _depot = get_depot();
+			const auto _block = new slot[OBJECT_POOL_BATCH_SIZE_V];
+			for (size_t n = 0; n != OBJECT_POOL_BATCH_SIZE_V - 1; ++n)
+			{
+				_block[n].link.next = &_block[n + 1];
+			};
+			_block[OBJECT_POOL_BATCH_SIZE_V - 1].link.next = nullptr;
+
+			std::unique_lock _lck{ _depot.mtx };
+			_depot.blocks.push_back(_block);
+			return _block;
+		};
+
+		// Takes a single slot straight from the depot, for threads whose cache has already been destroyed
+		static slot* allocate_uncached()
+		{
+			auto& _depot = get_depot();
+			{
+				std::unique_lock _lck{ _depot.mtx };
+				if (const auto _batch = _depot.batches; _batch)
+				{
+					if (_batch->link.batch_count > 1)
+					{
+						const auto _rest = _batch->link.next;
+						_rest->link.next_batch = _batch->link.next_batch;
+						_rest->link.batch_count = _batch->link.batch_count - 1;
+						_depot.batches = _rest;
+					}
+					else
+					{
+						_depot.batches = _batch->link.next_batch;
+					};
+					return _batch;
+				};
+			};
+
+			const auto _block = new_block();
+			_block[1].link.batch_count = OBJECT_POOL_BATCH_SIZE_V - 1;
+			give(&_block[1]);
+			return _block;
+		};
+
+	public:
+		/**
+		 * @brief Returns uninitialized storage for one T
+		*/
+		static void* allocate()
+		{
+			if (cache_state_ == cache_state::destroyed) [[unlikely]]
+			{
+				return allocate_uncached()->storage;
+			};
+
+			auto& _cache = get_cache();
+			if (!_cache.head) [[unlikely]]
+			{
+				refill(_cache);
+			};
+			const auto _slot = _cache.head;
+			_cache.head = _slot->link.next;
+			--_cache.count;
+			return _slot->storage;
+		};
+
+		/**
+		 * @brief Returns storage from allocate(), may be called from any thread
+		*/
+		static void deallocate(void* _ptr) noexcept
+		{
+			const auto _slot = static_cast<slot*>(_ptr);
+			if (cache_state_ == cache_state::destroyed) [[unlikely]]
+			{
+				// Freed during thread or program exit after the cache is gone, for example by a static object
+				_slot->link.next = nullptr;
+				_slot->link.batch_count = 1;
+				give(_slot);
+				return;
+			};
+
+			auto& _cache = get_cache();
+			_slot->link.next = _cache.head;
+			_cache.head = _slot;
+			if (++_cache.count >= OBJECT_POOL_BATCH_SIZE_V * 2) [[unlikely]]
+			{
+				give(_cache.take(OBJECT_POOL_BATCH_SIZE_V));
+			};
+		};
+
+		template <typename... Ts>
+		static T* make(Ts&&... _args)
+		{
+			const auto _ptr = allocate();
+			try
+			{
+				return new (_ptr) T(std::forward<Ts>(_args)...);
+			}
+			catch (...)
+			{
+				deallocate(_ptr);
+				throw;
+			};
+		};
+
+		static void destroy(T* _ptr) noexcept
+		{
+			if (_ptr)
+			{
+				_ptr->~T();
+				deallocate(_ptr);
+			};
+		};
+
+		/**
+		 * @brief Number of free slots cached by the calling thread
+		*/
+		static size_t cached() noexcept
+		{
+			return (cache_state_ == cache_state::destroyed) ? 0 : get_cache().count;
+		};
+
+	};
+
+	template <typename T, typename TagT = void>
+	struct pool_deleter
+	{
+		void operator()(T* _ptr) const noexcept
+		{
+			object_pool<T, TagT>::destroy(_ptr);
+		};
+	};
+
+	template <typename T, typename TagT = void>
+	using pool_unique_ptr = std::unique_ptr<T, pool_deleter<T, TagT>>;
+
+	template <typename T, typename TagT = void, typename... Ts>
+	static pool_unique_ptr<T, TagT> pool_make_unique(Ts&&... _cargs)
+	{
+		return pool_unique_ptr<T, TagT>{ object_pool<T, TagT>::make(std::forward<Ts>(_cargs)...) };
+	};
+};
+
+namespace std
+{
+	template <typename T>
+	struct hash<sae::intrusive_ptr<T>>
+	{
+		size_t operator()(const sae::intrusive_ptr<T>& _ptr) const noexcept
+		{
+			return std::hash<T*>{}(_ptr.get());
+		};
+	};
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,325 @@
+#pragma once
+#ifndef SAELIB_PROFILE_H
+#define SAELIB_PROFILE_H
+
+#include "SAELib_Time.h"
+
+#include <atomic>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <ostream>
+
+namespace sae
+{
+	// Sub buckets per power of two are 2^this, keeps bucket width under 1/32 of its values
+	constexpr static uint32_t HISTOGRAM_SUB_BUCKET_BITS_V = 5;
+
+	// Number of independent copies of the counters, threads are spread over them to avoid contention
+	constexpr static size_t HISTOGRAM_SHARD_COUNT_V = 4;
+
+	namespace impl
+	{
+		constexpr static size_t HISTOGRAM_SUB_BUCKETS_V = size_t{ 1 } << HISTOGRAM_SUB_BUCKET_BITS_V;
+		constexpr static size_t HISTOGRAM_BUCKET_COUNT_V = (64 - HISTOGRAM_SUB_BUCKET_BITS_V + 1) * HISTOGRAM_SUB_BUCKETS_V;
+
+		/**
+		 * @brief Bucket a value is counted in, values below HISTOGRAM_SUB_BUCKETS_V are exact and every power of
+		 * two above that is split into HISTOGRAM_SUB_BUCKETS_V linear steps
+		*/
+		constexpr static size_t histogram_bucket(uint64_t _value) noexcept
+		{
+			if (_value < HISTOGRAM_SUB_BUCKETS_V)
+			{
+				return (size_t)_value;
+			};
+			const auto _shift = (uint32_t)std::bit_width(_value) - 1 - HISTOGRAM_SUB_BUCKET_BITS_V;
+			return (size_t)(_shift + 1) * HISTOGRAM_SUB_BUCKETS_V + (size_t)((_value >> _shift) & (HISTOGRAM_SUB_BUCKETS_V - 1));
+		};
+
+		/**
+		 * @brief Smallest value counted in a bucket
+		*/
+		constexpr static uint64_t histogram_bucket_low(size_t _bucket) noexcept
+		{
+			if (_bucket < HISTOGRAM_SUB_BUCKETS_V)
+			{
+				return (uint64_t)_bucket;
+			};
+			const auto _shift = (uint32_t)(_bucket / HISTOGRAM_SUB_BUCKETS_V) - 1;
+			const auto _sub = (uint64_t)(_bucket % HISTOGRAM_SUB_BUCKETS_V) + HISTOGRAM_SUB_BUCKETS_V;
+			return _sub << _shift;
+		};
+
+		/**
+		 * @brief Largest value counted in a bucket
+		*/
+		constexpr static uint64_t histogram_bucket_high(size_t _bucket) noexcept
+		{
+			if (_bucket < HISTOGRAM_SUB_BUCKETS_V)
+			{
+				return (uint64_t)_bucket;
+			};
+			const auto _shift = (uint32_t)(_bucket / HISTOGRAM_SUB_BUCKETS_V) - 1;
+			return histogram_bucket_low(_bucket) + ((uint64_t{ 1 } << _shift) - 1);
+		};
+
+		/**
+		 * @brief Shard used by the calling thread, handed out round robin as threads first record
+		 *
+		 * Inline so every translation unit shares the counter and a thread gets the same shard everywhere.
+		*/
+		inline size_t histogram_shard_index() noexcept
+		{
+			static std::atomic<size_t> next_shard_{ 0 };
+			thread_local const size_t _shard = next_shard_.fetch_add(1, std::memory_order_relaxed) % HISTOGRAM_SHARD_COUNT_V;
+			return _shard;
+		};
+	};
+
+	/**
+	 * @brief Merged counts of a latency_histogram at some point in time
+	*/
+	class histogram_snapshot
+	{
+	public:
+		uint64_t count() const noexcept { return this->count_; };
+		uint64_t min() const noexcept { return (this->count_ == 0) ? 0 : this->min_; };
+		uint64_t max() const noexcept { return this->max_; };
+		double mean() const noexcept
+		{
+			return (this->count_ == 0) ? 0.0 : (double)this->sum_ / (double)this->count_;
+		};
+
+		/**
+		 * @brief Value below or equal to which the given fraction of recorded values fall
+		 * @param _fraction In [0, 1], for example 0.99 for p99
+		 * @return Upper end of the bucket holding that value, never more than max()
+		*/
+		uint64_t percentile(double _fraction) const noexcept
+		{
+			if (this->count_ == 0)
+			{
+				return 0;
+			};
+
+			_fraction = std::clamp(_fraction, 0.0, 1.0);
+			const auto _rank = std::max<uint64_t>((uint64_t)(_fraction * (double)this->count_ + 0.5), 1);
+			uint64_t _seen = 0;
+			for (size_t n = 0; n != this->buckets_.size(); ++n)
+			{
+				_seen += this->buckets_[n];
+				if (_seen >= _rank)
+				{
+					return std::clamp(impl::histogram_bucket_high(n), this->min(), this->max_);
+				};
+			};
+			return this->max_;
+		};
+
+		uint64_t p50() const noexcept { return this->percentile(0.5); };
+		uint64_t p99() const noexcept { return this->percentile(0.99); };
+		uint64_t p999() const noexcept { return this->percentile(0.999); };
+
+		/**
+		 * @brief Adds the counts of another snapshot to this one
+		*/
+		histogram_snapshot& merge(const histogram_snapshot& _other) noexcept
+		{
+			for (size_t n = 0; n != this->buckets_.size(); ++n)
+			{
+				this->buckets_[n] += _other.buckets_[n];
+			};
+			this->count_ += _other.count_;
+			this->sum_ += _other.sum_;
+			this->min_ = std::min(this->min_, _other.min_);
+			this->max_ = std::max(this->max_, _other.max_);
+			return *this;
+		};
+
+		/**
+		 * @brief Writes a summary line followed by one line per non empty bucket with its cumulative percentage
+		*/
+		void dump(std::ostream& _ostr) const
+		{
+			_ostr << "count=" << this->count() << " min=" << this->min() << " mean=" << this->mean() <<
+				" p50=" << this->p50() << " p99=" << this->p99() << " p999=" << this->p999() <<
+				" max=" << this->max() << '\n';
+
+			uint64_t _seen = 0;
+			for (size_t n = 0; n != this->buckets_.size(); ++n)
+			{
+				if (this->buckets_[n] == 0)
+				{
+					continue;
+				};
+				_seen += this->buckets_[n];
+				_ostr << impl::histogram_bucket_low(n) << '\t' << this->buckets_[n] << '\t' <<
+					(100.0 * (double)_seen / (double)this->count_) << "%\n";
+			};
+		};
+
+		histogram_snapshot() = default;
+
+	private:
+		friend class latency_histogram;
+
+		std::array<uint64_t, impl::HISTOGRAM_BUCKET_COUNT_V> buckets_{};
+		uint64_t count_ = 0;
+		uint64_t sum_ = 0;
+		uint64_t min_ = std::numeric_limits<uint64_t>::max();
+		uint64_t max_ = 0;
+
+	};
+
+	static std::ostream& operator<<(std::ostream& _ostr, const histogram_snapshot& _snapshot)
+	{
+		_snapshot.dump(_ostr);
+		return _ostr;
+	};
+
+	/**
+	 * @brief Log linear histogram of values, usually latencies in nanoseconds
+	 *
+	 * Recording is a few relaxed atomic adds on the calling thread's shard, shards are merged when snapshot() is
+	 * called. Bucket width grows with the value so the relative error stays under 1/32 across the whole uint64_t
+	 * range. A snapshot taken while other threads record may be off by the values recorded during the copy.
+	*/
+	class latency_histogram
+	{
+	public:
+		void record(uint64_t _value) noexcept
+		{
+			auto& _shard = (*this->shards_)[impl::histogram_shard_index()];
+			_shard.buckets[impl::histogram_bucket(_value)].fetch_add(1, std::memory_order_relaxed);
+			_shard.count.fetch_add(1, std::memory_order_relaxed);
+			_shard.sum.fetch_add(_value, std::memory_order_relaxed);
+
+			auto _min = _shard.min.load(std::memory_order_relaxed);
+			while (_value < _min && !_shard.min.compare_exchange_weak(_min, _value, std::memory_order_relaxed)) {};
+			auto _max = _shard.max.load(std::memory_order_relaxed);
+			while (_value > _max && !_shard.max.compare_exchange_weak(_max, _value, std::memory_order_relaxed)) {};
+		};
+
+		/**
+		 * @brief Records a duration in nanoseconds
+		*/
+		template <typename RepT, typename PeriodT>
+		void record(std::chrono::duration<RepT, PeriodT> _duration) noexcept
+		{
+			const auto _ns = std::chrono::duration_cast<std::chrono::nanoseconds>(_duration).count();
+			this->record((uint64_t)std::max<decltype(_ns)>(_ns, 0));
+		};
+
+		histogram_snapshot snapshot() const noexcept
+		{
+			histogram_snapshot _out{};
+			for (auto& _shard : *this->shards_)
+			{
+				for (size_t n = 0; n != _shard.buckets.size(); ++n)
+				{
+					_out.buckets_[n] += _shard.buckets[n].load(std::memory_order_relaxed);
+				};
+				_out.count_ += _shard.count.load(std::memory_order_relaxed);
+				_out.sum_ += _shard.sum.load(std::memory_order_relaxed);
+				_out.min_ = std::min(_out.min_, _shard.min.load(std::memory_order_relaxed));
+				_out.max_ = std::max(_out.max_, _shard.max.load(std::memory_order_relaxed));
+			};
+			return _out;
+		};
+
+		/**
+		 * @brief Clears all counts, values recorded concurrently may be partially kept
+		*/
+		void reset() noexcept
+		{
+			for (auto& _shard : *this->shards_)
+			{
+				for (auto& _bucket : _shard.buckets)
+				{
+					_bucket.store(0, std::memory_order_relaxed);
+				};
+				_shard.count.store(0, std::memory_order_relaxed);
+				_shard.sum.store(0, std::memory_order_relaxed);
+				_shard.min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+				_shard.max.store(0, std::memory_order_relaxed);
+			};
+		};
+
+		latency_histogram() :
+			shards_{ std::make_unique<std::array<shard, HISTOGRAM_SHARD_COUNT_V>>() }
+		{};
+
+	private:
+		struct alignas(64) shard
+		{
+			std::array<std::atomic<uint64_t>, impl::HISTOGRAM_BUCKET_COUNT_V> buckets{};
+			std::atomic<uint64_t> count{ 0 };
+			std::atomic<uint64_t> sum{ 0 };
+			std::atomic<uint64_t> min{ std::numeric_limits<uint64_t>::max() };
+			std::atomic<uint64_t> max{ 0 };
+		};
+
+		// Shards are large so they live on the heap
+		std::unique_ptr<std::array<shard, HISTOGRAM_SHARD_COUNT_V>> shards_;
+
+	};
+
+
+
+	/**
+	 * @brief Records the time between construction and destruction into a latency_histogram
+	*/
+	template <cx_clock ClockT = clock_t>
+	class scoped_timer
+	{
+	public:
+		using clock_type = ClockT;
+		using duration = typename clock_type::duration;
+		using time_point = typename clock_type::time_point;
+
+		duration elapsed_time() const
+		{
+			return this->clock_.now() - this->start_;
+		};
+
+		/**
+		 * @brief Stops the timer without recording anything
+		*/
+		void cancel() noexcept
+		{
+			this->histogram_ = nullptr;
+		};
+
+		explicit scoped_timer(latency_histogram& _histogram, clock_type _clock = clock_type{}) :
+			histogram_{ &_histogram }, clock_{ std::move(_clock) }, start_{ this->clock_.now() }
+		{};
+
+		scoped_timer(const scoped_timer& other) = delete;
+		scoped_timer& operator=(const scoped_timer& other) = delete;
+		scoped_timer(scoped_timer&& other) = delete;
+		scoped_timer& operator=(scoped_timer&& other) = delete;
+
+		~scoped_timer()
+		{
+			if (this->histogram_)
+			{
+				this->histogram_->record(this->elapsed_time());
+			};
+		};
+
+	private:
+		latency_histogram* histogram_;
+		mutable clock_type clock_;
+		time_point start_;
+
+	};
+
+};
+
+#endif
@@ -0,0 +1,232 @@
+#pragma once
+#ifndef SAELIB_RATE_LIMIT_H
+#define SAELIB_RATE_LIMIT_H
+
+#include "SAELib_Time.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include <thread>
+
+namespace sae
+{
+	namespace impl
+	{
+		/**
+		 * @brief Shared state of the rate limiters, the time at which the next unit is allowed if nothing has
+		 * been taken since (the theoretical arrival time) kept as a single atomic
+		*/
+		template <cx_clock ClockT>
+		class rate_limit_state
+		{
+		public:
+			using clock_type = ClockT;
+			using duration = typename clock_type::duration;
+			using time_point = typename clock_type::time_point;
+			using rep = typename duration::rep;
+
+			rep now() const
+			{
+				return this->clock_.now().time_since_epoch().count();
+			};
+
+			rep interval() const noexcept { return this->interval_; };
+
+			std::atomic<rep>& tat() noexcept { return this->tat_; };
+
+			/**
+			 * @brief Sleeps until the clock reaches _deadline, given as ticks since the clock's epoch
+			*/
+			void sleep_until(rep _deadline) const
+			{
+				for (auto _now = this->now(); _now < _deadline; _now = this->now())
+				{
+					std::this_thread::sleep_for(duration{ _deadline - _now });
+				};
+			};
+
+			rate_limit_state(double _ratePerSecond, clock_type _clock) :
+				clock_{ std::move(_clock) },
+				interval_{ std::max<rep>(std::chrono::duration_cast<duration>(
+					std::chrono::duration<double>{ 1.0 / std::max(_ratePerSecond, 1e-9) }).count(), 1) },
+				tat_{ this->now() }
+			{};
+
+		private:
+			mutable clock_type clock_;
+
+			// Clock ticks between units, at least one
+			rep interval_;
+
+			std::atomic<rep> tat_;
+
+		};
+	};
+
+	/**
+	 * @brief Token bucket rate limiter, allows bursts of up to burst units then refills at a fixed rate
+	 *
+	 * Implemented as the generic cell rate algorithm so the whole state is one timestamp updated with a
+	 * compare exchange, safe to call from any number of threads without locking. Starts full.
+	*/
+	template <cx_clock ClockT = clock_t>
+	class token_bucket
+	{
+	public:
+		using clock_type = ClockT;
+		using duration = typename clock_type::duration;
+
+		uint64_t burst() const noexcept { return this->burst_; };
+		duration interval() const noexcept { return duration{ this->state_.interval() }; };
+
+		/**
+		 * @brief Takes _n units if they are available right now
+		*/
+		bool try_acquire(uint64_t _n = 1)
+		{
+			const auto _now = this->state_.now();
+			const auto _limit = this->limit();
+			auto _tat = this->state_.tat().load(std::memory_order_relaxed);
+			while (true)
+			{
+				const auto _next = std::max(_tat, _now) + (rep)_n * this->state_.interval();
+				if (_next - _now > _limit)
+				{
+					return false;
+				};
+				if (this->state_.tat().compare_exchange_weak(_tat, _next, std::memory_order_relaxed))
+				{
+					return true;
+				};
+			};
+		};
+
+		/**
+		 * @brief Takes _n units, sleeping until they become available
+		 *
+		 * The units are reserved before sleeping so callers are served in the order they arrive.
+		 * @return False without waiting if _n is more than the burst size and could never be satisfied
+		*/
+		bool acquire(uint64_t _n = 1)
+		{
+			if (_n > this->burst_)
+			{
+				return false;
+			};
+
+			const auto _now = this->state_.now();
+			auto _tat = this->state_.tat().load(std::memory_order_relaxed);
+			auto _next = _tat;
+			do
+			{
+				_next = std::max(_tat, _now) + (rep)_n * this->state_.interval();
+			}
+			while (!this->state_.tat().compare_exchange_weak(_tat, _next, std::memory_order_relaxed));
+
+			this->state_.sleep_until(_next - this->limit());
+			return true;
+		};
+
+		/**
+		 * @param _ratePerSecond Units added back per second
+		 * @param _burst Most units that can be taken at once
+		*/
+		token_bucket(double _ratePerSecond, uint64_t _burst = 1, clock_type _clock = clock_type{}) :
+			state_{ _ratePerSecond, std::move(_clock) }, burst_{ std::max<uint64_t>(_burst, 1) }
+		{};
+
+	private:
+		using rep = typename impl::rate_limit_state<clock_type>::rep;
+
+		// How far ahead of now the theoretical arrival time may get
+		rep limit() const noexcept
+		{
+			return (rep)this->burst_ * this->state_.interval();
+		};
+
+		impl::rate_limit_state<clock_type> state_;
+		uint64_t burst_;
+
+	};
+
+	/**
+	 * @brief Leaky bucket rate limiter, hands out units strictly evenly spaced with no bursts
+	 *
+	 * Callers of acquire() queue up behind each other, up to capacity units may be waiting before further
+	 * callers are turned away. Lock free in the same way as token_bucket.
+	*/
+	template <cx_clock ClockT = clock_t>
+	class leaky_bucket
+	{
+	public:
+		using clock_type = ClockT;
+		using duration = typename clock_type::duration;
+
+		uint64_t capacity() const noexcept { return this->capacity_; };
+		duration interval() const noexcept { return duration{ this->state_.interval() }; };
+
+		/**
+		 * @brief Takes _n units if nothing is queued and the previous units have drained
+		*/
+		bool try_acquire(uint64_t _n = 1)
+		{
+			const auto _now = this->state_.now();
+			auto _tat = this->state_.tat().load(std::memory_order_relaxed);
+			while (true)
+			{
+				if (_tat > _now)
+				{
+					return false;
+				};
+				if (this->state_.tat().compare_exchange_weak(_tat, _now + (rep)_n * this->state_.interval(), std::memory_order_relaxed))
+				{
+					return true;
+				};
+			};
+		};
+
+		/**
+		 * @brief Takes _n units, sleeping until it is this caller's turn
+		 * @return False without waiting if the queue ahead is already more than capacity units long
+		*/
+		bool acquire(uint64_t _n = 1)
+		{
+			const auto _now = this->state_.now();
+			const auto _limit = (rep)this->capacity_ * this->state_.interval();
+			auto _tat = this->state_.tat().load(std::memory_order_relaxed);
+			while (true)
+			{
+				const auto _start = std::max(_tat, _now);
+				if (_start - _now > _limit)
+				{
+					return false;
+				};
+				if (this->state_.tat().compare_exchange_weak(_tat, _start + (rep)_n * this->state_.interval(), std::memory_order_relaxed))
+				{
+					this->state_.sleep_until(_start);
+					return true;
+				};
+			};
+		};
+
+		/**
+		 * @param _ratePerSecond Units let through per second
+		 * @param _capacity Most units that may be waiting in acquire()
+		*/
+		leaky_bucket(double _ratePerSecond, uint64_t _capacity = 64, clock_type _clock = clock_type{}) :
+			state_{ _ratePerSecond, std::move(_clock) }, capacity_{ _capacity }
+		{};
+
+	private:
+		using rep = typename impl::rate_limit_state<clock_type>::rep;
+
+		impl::rate_limit_state<clock_type> state_;
+		uint64_t capacity_;
+
+	};
+
+};
+
+#endif
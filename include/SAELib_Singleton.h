@@ -3,37 +3,34 @@
 #include <optional>
 #include <type_traits>
 #include <mutex>
+#include <utility>
 
 namespace sae
 {
 	namespace impl
 	{
-		template <typename T, typename TagT>
-		extern inline std::optional<T> SINGLETON_IMPL{ std::nullopt };
-	};
-
-	namespace impl
-	{
-		template <typename T> requires std::is_default_constructible_v<T>
-		constexpr static auto l_default_construct = [](std::optional<T>& _op) 
+		/**
+		 * @brief Owns the instance behind get_singleton<T, TagT>()
+		 *
+		 * Uses a function local static so construction happens once even with concurrent first calls, later
+		 * calls only pay for the compiler's guard check. Being a class member the function is shared by every
+		 * translation unit, so there is a single instance per program.
+		*/
+		template <typename T, typename TagT> requires std::is_default_constructible_v<T>
+		struct singleton_storage
 		{
-			_op.emplace();
+			static T& get()
+			{
+				static T instance_{};
+				return instance_;
+			};
 		};
 	};
 
-	template <typename T, typename TagT = void>
-		requires requires { impl::SINGLETON_IMPL<T, TagT>; }
+	template <typename T, typename TagT = void> requires std::is_default_constructible_v<T>
 	static T& get_singleton()
 	{
-		if (impl::SINGLETON_IMPL<T, TagT>.has_value()) [[likely]]
-		{
-			return impl::SINGLETON_IMPL<T, TagT>.value();
-		}
-		else
-		{
-			impl::SINGLETON_IMPL<T, TagT>.emplace();
-			return get_singleton<T, TagT>();
-		};
+		return impl::singleton_storage<T, TagT>::get();
 	};
 
 	template <typename T, typename TagT> requires std::is_default_constructible_v<T>
@@ -71,54 +68,32 @@ namespace sae
 
 	};
 
-	namespace impl
+	template <typename T, typename TagT = void> requires std::is_default_constructible_v<T>
+	static ThreadsafeSingleton<T, TagT>* get_singleton_threadsafe()
 	{
-		template <typename T, typename TagT> requires std::is_default_constructible_v<T>
-		extern inline std::mutex TS_SINGLETON_IMPL_MTX{};
-
-		template <typename T, typename TagT> requires std::is_default_constructible_v<T>
-		extern inline std::optional<ThreadsafeSingleton<T, TagT>> TS_SINGLETON_IMPL{ std::nullopt };
-
+		return &impl::singleton_storage<ThreadsafeSingleton<T, TagT>, TagT>::get();
 	};
 
-	template <typename T, typename TagT = void> requires requires { impl::TS_SINGLETON_IMPL<T, TagT>; }
-	static ThreadsafeSingleton<T, TagT>* get_singleton_threadsafe()
+	namespace impl
 	{
-		if (impl::TS_SINGLETON_IMPL<T, TagT>.has_value()) [[likely]]
-		{
-			return &impl::TS_SINGLETON_IMPL<T, TagT>.value();
-		}
-		else
+		/**
+		 * @brief Same as singleton_storage but with one instance per thread, constructed on the thread's first call
+		*/
+		template <typename T, typename TagT> requires std::is_default_constructible_v<T>
+		struct thread_local_singleton_storage
 		{
-			impl::TS_SINGLETON_IMPL_MTX<T, TagT>.lock();
-			if (!impl::TS_SINGLETON_IMPL<T, TagT>.has_value())
+			static T& get()
 			{
-				impl::TS_SINGLETON_IMPL<T, TagT>.emplace();
+				thread_local T instance_{};
+				return instance_;
 			};
-			impl::TS_SINGLETON_IMPL_MTX<T, TagT>.unlock();
-
-			return get_singleton_threadsafe<T, TagT>();
 		};
 	};
 
-	namespace impl
-	{
-		template <typename T, typename TagT> requires std::is_default_constructible_v<T>
-		extern thread_local inline std::optional<T> THREAD_LOCAL_SINGLETON_IMPL{ std::nullopt };
-	};
-
-	template <typename T, typename TagT = void> requires requires { impl::THREAD_LOCAL_SINGLETON_IMPL<T, TagT>; }
+	template <typename T, typename TagT = void> requires std::is_default_constructible_v<T>
 	static T& get_singleton_thread_local()
 	{
-		if (impl::THREAD_LOCAL_SINGLETON_IMPL<T, TagT>.has_value()) [[likely]]
-		{
-			return impl::THREAD_LOCAL_SINGLETON_IMPL<T, TagT>.value();
-		}
-		else
-		{
-			impl::THREAD_LOCAL_SINGLETON_IMPL<T, TagT>.emplace();
-			return get_singleton_thread_local<T, TagT>();
-		};
+		return impl::thread_local_singleton_storage<T, TagT>::get();
 	};
 
 	template <typename T, typename TagT>
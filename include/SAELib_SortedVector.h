@@ -1,111 +1,703 @@
 #pragma once
+#ifndef SAELIB_SORTED_VECTOR_H
+#define SAELIB_SORTED_VECTOR_H
 
-#include <SAELib_Concepts.h>
-#include <SAELib_Decorator.h>
+#include "SAELib_Concepts.h"
 
 #include <memory>
 #include <cstdint>
+#include <cstddef>
 #include <algorithm>
-#include <numeric>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
 #include <vector>
-
-
-#if false
+#include <bit>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SAELIB_PREFETCH(_ptr) __builtin_prefetch((const void*)(_ptr))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define SAELIB_PREFETCH(_ptr) _mm_prefetch((const char*)(_ptr), _MM_HINT_T0)
+#else
+#define SAELIB_PREFETCH(_ptr)
+#endif
 
 namespace sae
 {
+	namespace impl
+	{
+		template <typename CompareT>
+		concept cx_transparent_compare = requires { typename CompareT::is_transparent; };
+
+		/**
+		 * @brief Sorts the unsorted tail of a vector and merges it into the sorted front in a single pass
+		 *
+		 * Equivalent elements are removed keeping the first, so elements that were already in the sorted front win.
+		 *
+		 * @param _sortedCount Number of elements at the front of _vec that are already sorted and unique
+		*/
+		template <typename VectorT, typename CompareT>
+		static void merge_sorted_tail(VectorT& _vec, size_t _sortedCount, const CompareT& _less)
+		{
+			const auto _mid = _vec.begin() + _sortedCount;
+			std::stable_sort(_mid, _vec.end(), _less);
+			std::inplace_merge(_vec.begin(), _mid, _vec.end(), _less);
+
+			const auto _equivalent = [&_less](const auto& _lhs, const auto& _rhs)
+			{
+				return !_less(_lhs, _rhs) && !_less(_rhs, _lhs);
+			};
+			_vec.erase(std::unique(_vec.begin(), _vec.end(), _equivalent), _vec.end());
+		};
+
+		/**
+		 * @brief Binary search without a data dependent branch, the halving step compiles down to a conditional move
+		 * 
+		 * The middles of both halves that could be searched next are prefetched so the next step does not wait on memory.
+		 * 
+		 * @return Pointer to the first element not less than _key, or _base + _count if there is none
+		*/
+		template <typename T, typename KeyT, typename CompareT>
+		static const T* branchless_lower_bound(const T* _base, size_t _count, const KeyT& _key, const CompareT& _less)
+		{
+			if (_count == 0)
+			{
+				return _base;
+			};
+			while (_count > 1)
+			{
+				const auto _half = _count / 2;
+				SAELIB_PREFETCH(_base + _half / 2);
+				SAELIB_PREFETCH(_base + _half + _half / 2);
+				_base = (_less(_base[_half], _key)) ? _base + _half : _base;
+				_count -= _half;
+			};
+			return _base + (_less(*_base, _key) ? 1 : 0);
+		};
+
+		template <typename IterT, typename KeyT, typename CompareT>
+		static IterT branchless_lower_bound(IterT _begin, IterT _end, const KeyT& _key, const CompareT& _less)
+		{
+			const auto _count = (size_t)std::distance(_begin, _end);
+			const auto _base = std::to_address(_begin);
+			return _begin + (branchless_lower_bound(_base, _count, _key, _less) - _base);
+		};
+	};
+
+	/**
+	 * @brief Read only set stored in Eytzinger (breadth first) order
+	 * 
+	 * The first few levels of the search tree share the same cache lines, and the children of the node being
+	 * visited sit next to each other so they can be prefetched well ahead of the search. This beats a binary search
+	 * over a sorted array once the set no longer fits in cache. Iterating visits elements in tree order, not sorted order.
+	*/
+	template <typename T, typename CompareT = std::less<T>, typename AllocT = std::allocator<T>>
+	class eytzinger_set
+	{
+	public:
+		using value_type = T;
+		using key_type = T;
+		using key_compare = CompareT;
+		using allocator_type = AllocT;
+
+		using const_pointer = const value_type*;
+		using const_reference = const value_type&;
+		using size_type = size_t;
+
+		using container_type = std::vector<value_type, allocator_type>;
+		using const_iterator = typename container_type::const_iterator;
 
+	private:
+		// Node k is stored at index k - 1 so the children of node k are nodes 2k and 2k + 1
+		size_t search(const key_type& _key) const
+		{
+			// Prefetch the descendants four levels down, 16 nodes that are adjacent in memory
+			const auto _data = this->data_.data();
+			const auto _size = this->data_.size();
+			size_t k = 1;
+			while (k <= _size)
+			{
+				SAELIB_PREFETCH(_data + std::min(k * 16, _size) - 1);
+				k = 2 * k + (this->compare_(_data[k - 1], _key) ? 1 : 0);
+			};
+
+			// Undo the right turns taken after the last left turn, that node is the lower bound
+			return k >> (std::countr_one(k) + 1);
+		};
+
+		template <typename IterT>
+		IterT fill(IterT _sorted, size_t k)
+		{
+			if (k <= this->data_.size())
+			{
+				_sorted = this->fill(_sorted, 2 * k);
+				this->data_[k - 1] = *_sorted;
+				++_sorted;
+				_sorted = this->fill(_sorted, 2 * k + 1);
+			};
+			return _sorted;
+		};
+
+	public:
+		const_iterator begin() const noexcept { return this->data_.cbegin(); };
+		const_iterator end() const noexcept { return this->data_.cend(); };
+
+		size_type size() const noexcept { return this->data_.size(); };
+		bool empty() const noexcept { return this->data_.empty(); };
+
+		/**
+		 * @brief Finds the smallest element not less than _key
+		 * @return Pointer to the element or nullptr if there is none
+		*/
+		const_pointer lower_bound(const key_type& _key) const
+		{
+			const auto k = this->search(_key);
+			return (k == 0) ? nullptr : this->data_.data() + (k - 1);
+		};
+
+		/**
+		 * @brief Finds an element equivalent to _key
+		 * @return Pointer to the element or nullptr if there is none
+		*/
+		const_pointer find(const key_type& _key) const
+		{
+			const auto _it = this->lower_bound(_key);
+			return (_it && !this->compare_(_key, *_it)) ? _it : nullptr;
+		};
+
+		bool contains(const key_type& _key) const
+		{
+			return this->find(_key) != nullptr;
+		};
+
+		eytzinger_set() = default;
+
+		/**
+		 * @brief Builds the set from a range that is already sorted and unique
+		*/
+		template <typename IterT>
+		eytzinger_set(IterT _sortedFirst, IterT _sortedLast, const key_compare& _compare = key_compare{}, const allocator_type& _alloc = allocator_type{}) :
+			data_((size_t)std::distance(_sortedFirst, _sortedLast), _alloc), compare_{ _compare }
+		{
+			this->fill(_sortedFirst, 1);
+		};
+
+	private:
+		container_type data_{};
+		[[no_unique_address]] key_compare compare_{};
+
+	};
 
-	template <typename T, typename AllocT = std::allocator<T>>
-	class sorted_vector : public Decorate_Iterator<sorted_vector<T, AllocT>>
+	/**
+	 * @brief Set of unique values kept sorted in contiguous storage (a flat set)
+	 *
+	 * Lookups are a binary search over a vector, which beats node based sets when lookups are far more common than
+	 * inserts. Elements can not be modified in place as that could break the ordering, so all iterators are const.
+	*/
+	template <typename T, typename CompareT = std::less<T>, typename AllocT = std::allocator<T>>
+	class sorted_vector
 	{
 	public:
 		using value_type = T;
+		using key_type = T;
+		using key_compare = CompareT;
+		using value_compare = CompareT;
+		using allocator_type = AllocT;
+
 		using pointer = value_type*;
 		using reference = value_type&;
 		using const_pointer = const value_type*;
 		using const_reference = const value_type&;
 
-		using allocator_type = AllocT;
 		using size_type = size_t;
+		using difference_type = std::ptrdiff_t;
 
-	private:
-		friend Decorate_Iterator<sorted_vector<T, AllocT>>;
+		using container_type = std::vector<value_type, allocator_type>;
 
-		using container_type = typename std::vector<value_type, allocator_type>;
+		using iterator = typename container_type::const_iterator;
+		using const_iterator = typename container_type::const_iterator;
+		using reverse_iterator = typename container_type::const_reverse_iterator;
+		using const_reverse_iterator = typename container_type::const_reverse_iterator;
 
+	private:
 		container_type& get_container() noexcept { return this->data_; };
 		const container_type& get_container() const noexcept { return this->data_; };
 
+		// Only valid for the result of lower_bound(), which is never less than the key
+		template <typename KeyT>
+		bool equivalent(const value_type& _value, const KeyT& _key) const
+		{
+			return !this->compare_(_key, _value);
+		};
+
+	public:
+		const_iterator begin() const noexcept { return this->get_container().cbegin(); };
+		const_iterator cbegin() const noexcept { return this->get_container().cbegin(); };
+		const_iterator end() const noexcept { return this->get_container().cend(); };
+		const_iterator cend() const noexcept { return this->get_container().cend(); };
+
+		const_reverse_iterator rbegin() const noexcept { return this->get_container().crbegin(); };
+		const_reverse_iterator crbegin() const noexcept { return this->get_container().crbegin(); };
+		const_reverse_iterator rend() const noexcept { return this->get_container().crend(); };
+		const_reverse_iterator crend() const noexcept { return this->get_container().crend(); };
+
+		size_type size() const noexcept { return this->get_container().size(); };
+		bool empty() const noexcept { return this->get_container().empty(); };
+
+		size_type capacity() const noexcept { return this->get_container().capacity(); };
+		void reserve(size_type _count) { this->get_container().reserve(_count); };
+		void shrink_to_fit() { this->get_container().shrink_to_fit(); };
+		void clear() noexcept { this->get_container().clear(); };
+
+		const_pointer data() const noexcept { return this->get_container().data(); };
+
+		const_reference front() const noexcept { return this->get_container().front(); };
+		const_reference back() const noexcept { return this->get_container().back(); };
+
+		const_reference at(size_type _index) const { return this->get_container().at(_index); };
+		const_reference operator[](size_type _index) const noexcept { return this->get_container()[_index]; };
+
+		const container_type& container() const noexcept { return this->get_container(); };
+
+		/**
+		 * @brief Makes a read only copy in Eytzinger layout for lookup heavy use
+		*/
+		eytzinger_set<value_type, key_compare, allocator_type> freeze() const
+		{
+			return { this->begin(), this->end(), this->compare_, this->get_allocator() };
+		};
+
+		key_compare key_comp() const { return this->compare_; };
+		value_compare value_comp() const { return this->compare_; };
+
+		allocator_type get_allocator() const { return this->get_container().get_allocator(); };
+
+
+
+		const_iterator lower_bound(const key_type& _key) const
+		{
+			return impl::branchless_lower_bound(this->begin(), this->end(), _key, this->compare_);
+		};
+		template <typename KeyT> requires impl::cx_transparent_compare<key_compare>
+		const_iterator lower_bound(const KeyT& _key) const
+		{
+			return impl::branchless_lower_bound(this->begin(), this->end(), _key, this->compare_);
+		};
+
+		const_iterator upper_bound(const key_type& _key) const
+		{
+			return std::upper_bound(this->begin(), this->end(), _key, this->compare_);
+		};
+		template <typename KeyT> requires impl::cx_transparent_compare<key_compare>
+		const_iterator upper_bound(const KeyT& _key) const
+		{
+			return std::upper_bound(this->begin(), this->end(), _key, this->compare_);
+		};
+
+		std::pair<const_iterator, const_iterator> equal_range(const key_type& _key) const
+		{
+			const auto _it = this->lower_bound(_key);
+			return { _it, (_it != this->end() && this->equivalent(*_it, _key)) ? std::next(_it) : _it };
+		};
+
+		const_iterator find(const key_type& _key) const
+		{
+			const auto _it = this->lower_bound(_key);
+			return (_it != this->end() && this->equivalent(*_it, _key)) ? _it : this->end();
+		};
+		template <typename KeyT> requires impl::cx_transparent_compare<key_compare>
+		const_iterator find(const KeyT& _key) const
+		{
+			const auto _it = this->lower_bound(_key);
+			return (_it != this->end() && this->equivalent(*_it, _key)) ? _it : this->end();
+		};
+
+		bool contains(const key_type& _key) const
+		{
+			return this->find(_key) != this->end();
+		};
+		template <typename KeyT> requires impl::cx_transparent_compare<key_compare>
+		bool contains(const KeyT& _key) const
+		{
+			return this->find(_key) != this->end();
+		};
+
+		size_type count(const key_type& _key) const
+		{
+			return (this->contains(_key)) ? 1 : 0;
+		};
+
+
+
+		/**
+		 * @brief Inserts a value if an equivalent one is not already present
+		 * @return Iterator to the inserted or existing value and true if it was inserted
+		*/
+		std::pair<const_iterator, bool> insert(const value_type& _value)
+		{
+			return this->emplace(_value);
+		};
+		std::pair<const_iterator, bool> insert(value_type&& _value)
+		{
+			return this->emplace(std::move(_value));
+		};
+
+		template <typename... ArgTs>
+		std::pair<const_iterator, bool> emplace(ArgTs&&... _args)
+		{
+			value_type _value{ std::forward<ArgTs>(_args)... };
+			auto _it = this->lower_bound(_value);
+			if (_it != this->end() && this->equivalent(*_it, _value))
+			{
+				return { _it, false };
+			};
+			const auto _offset = std::distance(this->cbegin(), _it);
+			auto& _data = this->get_container();
+			return { _data.insert(_data.begin() + _offset, std::move(_value)), true };
+		};
+
+		/**
+		 * @brief Inserts a range of values, appending them and then sorting and merging once
+		*/
+		template <typename IterT>
+		void insert(IterT _first, IterT _last)
+		{
+			auto& _data = this->get_container();
+			const auto _sortedCount = _data.size();
+			_data.insert(_data.end(), _first, _last);
+			impl::merge_sorted_tail(_data, _sortedCount, this->compare_);
+		};
+		void insert(std::initializer_list<value_type> _values)
+		{
+			this->insert(_values.begin(), _values.end());
+		};
+
+
+
+		const_iterator erase(const_iterator _pos)
+		{
+			return this->get_container().erase(_pos);
+		};
+		const_iterator erase(const_iterator _first, const_iterator _last)
+		{
+			return this->get_container().erase(_first, _last);
+		};
+		size_type erase(const key_type& _key)
+		{
+			const auto _it = this->find(_key);
+			if (_it == this->end())
+			{
+				return 0;
+			};
+			this->erase(_it);
+			return 1;
+		};
+
+
+
+		friend inline bool operator==(const sorted_vector& _lhs, const sorted_vector& _rhs)
+		{
+			return _lhs.get_container() == _rhs.get_container();
+		};
+
+
+
+		sorted_vector() = default;
+		explicit sorted_vector(const key_compare& _compare, const allocator_type& _alloc = allocator_type{}) :
+			data_(_alloc), compare_{ _compare }
+		{};
+		explicit sorted_vector(const allocator_type& _alloc) :
+			data_(_alloc), compare_{}
+		{};
+
+		template <typename IterT>
+		sorted_vector(IterT _first, IterT _last, const key_compare& _compare = key_compare{}, const allocator_type& _alloc = allocator_type{}) :
+			sorted_vector{ _compare, _alloc }
+		{
+			this->insert(_first, _last);
+		};
+		sorted_vector(std::initializer_list<value_type> _values, const key_compare& _compare = key_compare{}, const allocator_type& _alloc = allocator_type{}) :
+			sorted_vector{ _values.begin(), _values.end(), _compare, _alloc }
+		{};
+
+	private:
+		container_type data_{};
+		[[no_unique_address]] key_compare compare_{};
+
+	};
+
+
+
+	namespace impl
+	{
+		// Compares flat_map pairs by key, and pairs against bare keys for lookups
+		template <typename KeyT, typename ValueT, typename CompareT>
+		struct flat_map_compare
+		{
+			using is_transparent = void;
+			using pair_type = std::pair<KeyT, ValueT>;
+
+			bool operator()(const pair_type& _lhs, const pair_type& _rhs) const { return this->compare(_lhs.first, _rhs.first); };
+			bool operator()(const pair_type& _lhs, const KeyT& _rhs) const { return this->compare(_lhs.first, _rhs); };
+			bool operator()(const KeyT& _lhs, const pair_type& _rhs) const { return this->compare(_lhs, _rhs.first); };
+
+			[[no_unique_address]] CompareT compare{};
+		};
+	};
+
+	/**
+	 * @brief Map of unique keys to values kept sorted by key in contiguous storage
+	 *
+	 * Same trade offs as sorted_vector, values can be modified in place through iterators but keys must not be.
+	*/
+	template <typename KeyT, typename ValueT, typename CompareT = std::less<KeyT>, typename AllocT = std::allocator<std::pair<KeyT, ValueT>>>
+	class flat_map
+	{
 	public:
+		using key_type = KeyT;
+		using mapped_type = ValueT;
+		using value_type = std::pair<key_type, mapped_type>;
+		using key_compare = CompareT;
+		using allocator_type = AllocT;
+
+		using pointer = value_type*;
+		using reference = value_type&;
+		using const_pointer = const value_type*;
+		using const_reference = const value_type&;
+
+		using size_type = size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using container_type = std::vector<value_type, allocator_type>;
+
 		using iterator = typename container_type::iterator;
 		using const_iterator = typename container_type::const_iterator;
 		using reverse_iterator = typename container_type::reverse_iterator;
 		using const_reverse_iterator = typename container_type::const_reverse_iterator;
 
 	private:
+		using pair_compare = impl::flat_map_compare<key_type, mapped_type, key_compare>;
+
+		container_type& get_container() noexcept { return this->data_; };
+		const container_type& get_container() const noexcept { return this->data_; };
+
+		// Only valid for the result of lower_bound(), which is never less than the key
+		bool equivalent(const value_type& _value, const key_type& _key) const
+		{
+			return !this->compare_(_key, _value);
+		};
+
+	public:
+		iterator begin() noexcept { return this->get_container().begin(); };
+		const_iterator begin() const noexcept { return this->get_container().cbegin(); };
+		const_iterator cbegin() const noexcept { return this->get_container().cbegin(); };
+		iterator end() noexcept { return this->get_container().end(); };
+		const_iterator end() const noexcept { return this->get_container().cend(); };
+		const_iterator cend() const noexcept { return this->get_container().cend(); };
+
+		reverse_iterator rbegin() noexcept { return this->get_container().rbegin(); };
+		const_reverse_iterator rbegin() const noexcept { return this->get_container().crbegin(); };
+		reverse_iterator rend() noexcept { return this->get_container().rend(); };
+		const_reverse_iterator rend() const noexcept { return this->get_container().crend(); };
 
-		struct Range
+		size_type size() const noexcept { return this->get_container().size(); };
+		bool empty() const noexcept { return this->get_container().empty(); };
+
+		size_type capacity() const noexcept { return this->get_container().capacity(); };
+		void reserve(size_type _count) { this->get_container().reserve(_count); };
+		void shrink_to_fit() { this->get_container().shrink_to_fit(); };
+		void clear() noexcept { this->get_container().clear(); };
+
+		key_compare key_comp() const { return this->compare_.compare; };
+		allocator_type get_allocator() const { return this->get_container().get_allocator(); };
+
+
+
+		iterator lower_bound(const key_type& _key)
+		{
+			return impl::branchless_lower_bound(this->begin(), this->end(), _key, this->compare_);
+		};
+		const_iterator lower_bound(const key_type& _key) const
+		{
+			return impl::branchless_lower_bound(this->begin(), this->end(), _key, this->compare_);
+		};
+
+		iterator upper_bound(const key_type& _key)
+		{
+			return std::upper_bound(this->begin(), this->end(), _key, this->compare_);
+		};
+		const_iterator upper_bound(const key_type& _key) const
 		{
-			using value_type = typename pointer;
-			value_type first;
-			value_type second;
-			Range(value_type _f, value_type _s) noexcept :
-				first{ _f }, second{ _s }
-			{};
+			return std::upper_bound(this->begin(), this->end(), _key, this->compare_);
 		};
 
-		auto check_range(Range _in, const T& _key) noexcept
+		iterator find(const key_type& _key)
 		{
-			auto _middle = std::midpoint(_in.first, _in.second);
-			if (_key < *_middle)
+			const auto _it = this->lower_bound(_key);
+			return (_it != this->end() && this->equivalent(*_it, _key)) ? _it : this->end();
+		};
+		const_iterator find(const key_type& _key) const
+		{
+			const auto _it = this->lower_bound(_key);
+			return (_it != this->end() && this->equivalent(*_it, _key)) ? _it : this->end();
+		};
+
+		bool contains(const key_type& _key) const
+		{
+			return this->find(_key) != this->end();
+		};
+		size_type count(const key_type& _key) const
+		{
+			return (this->contains(_key)) ? 1 : 0;
+		};
+
+		mapped_type& at(const key_type& _key)
+		{
+			const auto _it = this->find(_key);
+			if (_it == this->end())
 			{
-				return Range(_in.first, _middle);
-			}
-			else
+				throw std::out_of_range{ "flat_map::at key not found" };
+			};
+			return _it->second;
+		};
+		const mapped_type& at(const key_type& _key) const
+		{
+			const auto _it = this->find(_key);
+			if (_it == this->end())
+			{
+				throw std::out_of_range{ "flat_map::at key not found" };
+			};
+			return _it->second;
+		};
+
+		mapped_type& operator[](const key_type& _key)
+		{
+			return this->try_emplace(_key).first->second;
+		};
+
+
+
+		/**
+		 * @brief Inserts a key if it is not already present, constructing the value from _args
+		 * @return Iterator to the inserted or existing pair and true if it was inserted
+		*/
+		template <typename... ArgTs>
+		std::pair<iterator, bool> try_emplace(const key_type& _key, ArgTs&&... _args)
+		{
+			auto _it = this->lower_bound(_key);
+			if (_it != this->end() && this->equivalent(*_it, _key))
 			{
-				return Range(_middle, _in.second);
+				return { _it, false };
 			};
+			_it = this->get_container().emplace(_it, std::piecewise_construct,
+				std::forward_as_tuple(_key), std::forward_as_tuple(std::forward<ArgTs>(_args)...));
+			return { _it, true };
 		};
 
-		auto find_lower_bound(const T& _k)
+		template <typename... ArgTs>
+		std::pair<iterator, bool> emplace(ArgTs&&... _args)
 		{
-			Range _r{ this->get_container().data(), this->get_container().data() + this->get_container().size() };
-			while (std::distance(_r.first, _r.second) > 1)
+			value_type _value{ std::forward<ArgTs>(_args)... };
+			auto _it = this->lower_bound(_value.first);
+			if (_it != this->end() && this->equivalent(*_it, _value.first))
 			{
-				_r = check_range(_r, _k);
+				return { _it, false };
 			};
-			return _r.first;
+			return { this->get_container().insert(_it, std::move(_value)), true };
 		};
 
+		std::pair<iterator, bool> insert(const value_type& _value)
+		{
+			return this->emplace(_value);
+		};
+		std::pair<iterator, bool> insert(value_type&& _value)
+		{
+			return this->emplace(std::move(_value));
+		};
 
-	public:
+		template <typename MappedT>
+		std::pair<iterator, bool> insert_or_assign(const key_type& _key, MappedT&& _value)
+		{
+			auto _result = this->try_emplace(_key, std::forward<MappedT>(_value));
+			if (!_result.second)
+			{
+				_result.first->second = std::forward<MappedT>(_value);
+			};
+			return _result;
+		};
+
+		/**
+		 * @brief Inserts a range of pairs, appending them and then sorting and merging once
+		*/
+		template <typename IterT>
+		void insert(IterT _first, IterT _last)
+		{
+			auto& _data = this->get_container();
+			const auto _sortedCount = _data.size();
+			_data.insert(_data.end(), _first, _last);
+			impl::merge_sorted_tail(_data, _sortedCount, this->compare_);
+		};
+		void insert(std::initializer_list<value_type> _values)
+		{
+			this->insert(_values.begin(), _values.end());
+		};
 
 
 
-		template <cx_forward<value_type> _T>
-		void insert(_T&& _val)
+		iterator erase(const_iterator _pos)
+		{
+			return this->get_container().erase(_pos);
+		};
+		iterator erase(const_iterator _first, const_iterator _last)
 		{
-			auto _it = this->find_lower_bound(_val);
-			if ((this->data_.size() == 1) || (_it != this->data_.data() && _it != this->data_.data() + this->data_.size()))
+			return this->get_container().erase(_first, _last);
+		};
+		size_type erase(const key_type& _key)
+		{
+			const auto _it = this->find(_key);
+			if (_it == this->end())
 			{
-				++_it;
+				return 0;
 			};
-			this->get_container().insert(this->begin() + std::distance(this->data_.data(), _it), std::forward<_T>(_val));
+			this->erase(_it);
+			return 1;
 		};
 
 
 
+		friend inline bool operator==(const flat_map& _lhs, const flat_map& _rhs)
+		{
+			return _lhs.get_container() == _rhs.get_container();
+		};
 
 
-	private:
-		container_type data_;
-
-	};
 
+		flat_map() = default;
+		explicit flat_map(const key_compare& _compare, const allocator_type& _alloc = allocator_type{}) :
+			data_(_alloc), compare_{ _compare }
+		{};
+		explicit flat_map(const allocator_type& _alloc) :
+			data_(_alloc), compare_{}
+		{};
 
+		template <typename IterT>
+		flat_map(IterT _first, IterT _last, const key_compare& _compare = key_compare{}, const allocator_type& _alloc = allocator_type{}) :
+			flat_map{ _compare, _alloc }
+		{
+			this->insert(_first, _last);
+		};
+		flat_map(std::initializer_list<value_type> _values, const key_compare& _compare = key_compare{}, const allocator_type& _alloc = allocator_type{}) :
+			flat_map{ _values.begin(), _values.end(), _compare, _alloc }
+		{};
 
+	private:
+		container_type data_{};
+		[[no_unique_address]] pair_compare compare_{};
 
+	};
 
 };
 
@@ -3,6 +3,7 @@
 #define SAELIB_STREAM_H
 
 #include "SAELib_Type.h"
+#include "SAELib_Thread.h"
 
 #include <istream>
 #include <iterator>
@@ -10,6 +11,13 @@
 #include <algorithm>
 #include <vector>
 #include <iostream>
+#include <cstddef>
+#include <span>
+#include <deque>
+#include <numeric>
+#include <optional>
+#include <mutex>
+#include <condition_variable>
 
 namespace sae
 {
@@ -109,6 +117,157 @@ namespace sae
 
 
 
+	constexpr static size_t CHUNKED_READER_CHUNK_SIZE_V = DRAIN_READ_CHUNK_SIZE_V * 64;
+	constexpr static size_t CHUNKED_READER_BUFFER_COUNT_V = 2;
+
+	/**
+	 * @brief Reads an input stream in fixed size chunks on a background thread.
+	 * 
+	 * Chunks are read into a pool of reusable buffers, so the next chunk is read while the caller
+	 * is still processing the current one. A chunk returned by next() stays valid until the following
+	 * call to next() or until the reader is destroyed.
+	*/
+	class chunked_reader
+	{
+	public:
+		using chunk_type = std::span<const std::byte>;
+
+		size_t chunk_size() const noexcept { return this->chunk_size_; };
+		size_t buffer_count() const noexcept { return this->buffers_.size(); };
+
+		/**
+		 * @brief Returns the previous chunk to the buffer pool and waits for the next one
+		 * @return View of the next chunk, or nullopt once the stream has been fully read
+		*/
+		std::optional<chunk_type> next()
+		{
+			std::unique_lock<std::mutex> _lck{ this->mtx_ };
+			if (this->current_ != npos)
+			{
+				this->free_.push_back(std::exchange(this->current_, npos));
+				this->cv_.notify_all();
+			};
+
+			this->cv_.wait(_lck, [this]() { return !this->filled_.empty() || this->done_; });
+			if (this->filled_.empty())
+			{
+				return std::nullopt;
+			};
+
+			this->current_ = this->filled_.front();
+			this->filled_.pop_front();
+
+			const auto& _buff = this->buffers_[this->current_];
+			return chunk_type{ _buff.data.data(), _buff.size };
+		};
+
+		/**
+		 * @brief Checks if every chunk has been read and handed out by next()
+		*/
+		bool eof() const
+		{
+			std::unique_lock<std::mutex> _lck{ this->mtx_ };
+			return this->done_ && this->filled_.empty();
+		};
+
+		chunked_reader(std::istream& _istr, size_t _chunkSize = CHUNKED_READER_CHUNK_SIZE_V, size_t _bufferCount = CHUNKED_READER_BUFFER_COUNT_V) :
+			istr_{ &_istr }, chunk_size_{ _chunkSize },
+			buffers_(std::max<size_t>(_bufferCount, 1)), free_{ make_free_list(this->buffers_.size()) },
+			thread_{ &chunked_reader::read_main, this }
+		{};
+
+		chunked_reader(const chunked_reader& other) = delete;
+		chunked_reader& operator=(const chunked_reader& other) = delete;
+		chunked_reader(chunked_reader&& other) = delete;
+		chunked_reader& operator=(chunked_reader&& other) = delete;
+
+		~chunked_reader()
+		{
+			this->mtx_.lock();
+			this->stop_ = true;
+			this->mtx_.unlock();
+			this->cv_.notify_all();
+			this->thread_.shutdown();
+		};
+
+	private:
+		constexpr static size_t npos = static_cast<size_t>(-1);
+
+		struct buffer
+		{
+			std::vector<std::byte> data{};
+			size_t size = 0;
+		};
+
+		static std::deque<size_t> make_free_list(size_t _count)
+		{
+			std::deque<size_t> _out(_count);
+			std::iota(_out.begin(), _out.end(), size_t{ 0 });
+			return _out;
+		};
+
+		void read_main()
+		{
+			bool _done = false;
+			while (!_done)
+			{
+				size_t _index = npos;
+				{
+					std::unique_lock<std::mutex> _lck{ this->mtx_ };
+					this->cv_.wait(_lck, [this]() { return !this->free_.empty() || this->stop_; });
+					if (this->stop_)
+					{
+						break;
+					};
+					_index = this->free_.front();
+					this->free_.pop_front();
+				};
+
+				// The buffer is owned by this thread until it is pushed to the filled queue
+				auto& _buff = this->buffers_[_index];
+				_buff.data.resize(this->chunk_size());
+				this->istr_->read((char*)_buff.data.data(), _buff.data.size());
+				_buff.size = (size_t)this->istr_->gcount();
+				_done = !this->istr_->good();
+
+				{
+					std::unique_lock<std::mutex> _lck{ this->mtx_ };
+					if (_buff.size != 0)
+					{
+						this->filled_.push_back(_index);
+					}
+					else
+					{
+						this->free_.push_back(_index);
+					};
+				};
+				this->cv_.notify_all();
+			};
+
+			this->mtx_.lock();
+			this->done_ = true;
+			this->mtx_.unlock();
+			this->cv_.notify_all();
+		};
+
+		std::istream* istr_;
+		size_t chunk_size_;
+
+		std::vector<buffer> buffers_;
+		std::deque<size_t> free_;
+		std::deque<size_t> filled_{};
+		size_t current_ = npos;
+
+		mutable std::mutex mtx_{};
+		std::condition_variable cv_{};
+		bool stop_ = false;
+		bool done_ = false;
+
+		// Must be last so the reader is fully constructed before the thread starts
+		ithread thread_;
+	};
+
+
 	/**
 	 * @brief Sets std::cout and std::cin to be redirected into a different set of streams
 	 * @param _stdin std::cout will now output into this istream
@@ -41,12 +41,13 @@ namespace sae
 			redirect_standard_io(this->rin, this->rout);
 
 			std::string _uinput{};
+			token_list _tkns{};
 			while (this->thread_.is_running() && this->keep_open())
 			{
 				cout << color::green << "$ " << color::none;
 				std::getline(cin, _uinput, '\n');
 
-				auto _tkns = split_not_empty(_uinput, ' ');
+				this->tokenizer_.tokenize_into(_uinput, _tkns);
 
 				if (this->echo)
 				{
@@ -91,6 +92,8 @@ namespace sae
 		
 	private:
 		resource_guard<command_set> commands_{};
+		// No escape character so backslashes in typed Windows paths are kept, quotes still group arguments
+		tokenizer tokenizer_{ whitespace_delimiters_v, '"', '\0' };
 		ithread thread_{};
 
 		std::istringstream rin{};
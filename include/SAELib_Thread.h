@@ -11,6 +11,19 @@
 #include <type_traits>
 #include <mutex>
 #include <iostream>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#endif
 
 namespace sae
 {
@@ -52,6 +65,88 @@ namespace sae
 
 
 
+	/**
+	 * @brief Hint to the CPU that this is a spin wait loop
+	*/
+	static void cpu_relax() noexcept
+	{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+		_mm_pause();
+#elif (defined(__aarch64__) || defined(__arm__)) && (defined(__GNUC__) || defined(__clang__))
+		asm volatile("yield");
+#endif
+	};
+
+	namespace impl
+	{
+		/**
+		 * @brief Running estimate of how late the OS wakes a sleeping thread
+		 *
+		 * Mean and mean deviation are tracked like a TCP retransmit timer, updates from different threads may
+		 * interleave which only makes the estimate a little noisier.
+		*/
+		struct precise_sleep_estimate
+		{
+			std::atomic<int64_t> mean_ns{ 50000 };
+			std::atomic<int64_t> deviation_ns{ 25000 };
+
+			nanoseconds margin() const noexcept
+			{
+				return nanoseconds{ this->mean_ns.load(std::memory_order_relaxed) + 4 * this->deviation_ns.load(std::memory_order_relaxed) };
+			};
+
+			void record(nanoseconds _late) noexcept
+			{
+				const auto _sample = std::max<int64_t>(_late.count(), 0);
+				auto _mean = this->mean_ns.load(std::memory_order_relaxed);
+				auto _deviation = this->deviation_ns.load(std::memory_order_relaxed);
+				_deviation += (std::abs(_sample - _mean) - _deviation) / 4;
+				_mean += (_sample - _mean) / 8;
+				this->mean_ns.store(_mean, std::memory_order_relaxed);
+				this->deviation_ns.store(_deviation, std::memory_order_relaxed);
+			};
+		};
+
+		struct SAELib_Thread_H_PreciseSleepSingletonTag {};
+
+		// Inline so every translation unit learns from the same estimate
+		inline precise_sleep_estimate& get_precise_sleep_estimate() noexcept
+		{
+			return get_singleton<precise_sleep_estimate, SAELib_Thread_H_PreciseSleepSingletonTag>();
+		};
+	};
+
+	/**
+	 * @brief Sleeps until shortly before _deadline and spins for the rest, for when waking late matters
+	 *
+	 * The sleep stops early by a margin learned from how late previous sleeps woke up, so the spin usually
+	 * lasts tens of microseconds. Never returns before _deadline.
+	*/
+	static void precise_sleep_until(time_point _deadline)
+	{
+		auto& _estimate = impl::get_precise_sleep_estimate();
+		const auto _wakeAt = _deadline - std::chrono::duration_cast<duration>(_estimate.margin());
+
+		auto _now = clock().now();
+		if (_now < _wakeAt)
+		{
+			std::this_thread::sleep_for(_wakeAt - _now);
+			_now = clock().now();
+			_estimate.record(_now - _wakeAt);
+		};
+
+		while (_now < _deadline)
+		{
+			cpu_relax();
+			_now = clock().now();
+		};
+	};
+
+	static void precise_sleep_for(duration _duration)
+	{
+		precise_sleep_until(clock().now() + _duration);
+	};
+
 	struct thread
 	{
 	public:
@@ -218,6 +313,255 @@ namespace sae
 
 	};
 
+	constexpr static milliseconds COARSE_CLOCK_INTERVAL_V{ 1 };
+
+	namespace impl
+	{
+		/**
+		 * @brief Background thread that stores the steady_clock time every interval for coarse_clock to read
+		*/
+		class coarse_clock_ticker
+		{
+		public:
+			int64_t load() const noexcept
+			{
+				return this->now_ns_.load(std::memory_order_relaxed);
+			};
+
+			nanoseconds interval() const
+			{
+				std::unique_lock<std::mutex> _lck{ this->mtx_ };
+				return this->interval_;
+			};
+			void set_interval(nanoseconds _interval)
+			{
+				{
+					std::unique_lock<std::mutex> _lck{ this->mtx_ };
+					this->interval_ = std::max(_interval, nanoseconds{ 1 });
+				};
+				this->cv_.notify_all();
+			};
+
+			coarse_clock_ticker() :
+				thread_{ &coarse_clock_ticker::run_main, this }
+			{};
+
+			coarse_clock_ticker(const coarse_clock_ticker& other) = delete;
+			coarse_clock_ticker& operator=(const coarse_clock_ticker& other) = delete;
+			coarse_clock_ticker(coarse_clock_ticker&& other) = delete;
+			coarse_clock_ticker& operator=(coarse_clock_ticker&& other) = delete;
+
+			~coarse_clock_ticker()
+			{
+				this->mtx_.lock();
+				this->stop_ = true;
+				this->mtx_.unlock();
+				this->cv_.notify_all();
+				this->thread_.shutdown();
+			};
+
+		private:
+			static int64_t steady_ns() noexcept
+			{
+				return std::chrono::duration_cast<nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			};
+
+			void run_main()
+			{
+				std::unique_lock<std::mutex> _lck{ this->mtx_ };
+				while (!this->stop_)
+				{
+					this->now_ns_.store(steady_ns(), std::memory_order_relaxed);
+					this->cv_.wait_for(_lck, this->interval_);
+				};
+			};
+
+			std::atomic<int64_t> now_ns_{ steady_ns() };
+			nanoseconds interval_{ COARSE_CLOCK_INTERVAL_V };
+			mutable std::mutex mtx_{};
+			std::condition_variable cv_{};
+			bool stop_ = false;
+
+			// Declared last so everything above exists before the thread starts
+			ithread thread_;
+
+		};
+
+		struct SAELib_Thread_H_CoarseClockSingletonTag {};
+
+		// Inline so every translation unit shares the one ticker thread
+		inline coarse_clock_ticker& get_coarse_clock_ticker()
+		{
+			return get_singleton<coarse_clock_ticker, SAELib_Thread_H_CoarseClockSingletonTag>();
+		};
+	};
+
+	/**
+	 * @brief Clock whose now() is a relaxed atomic load, for hot paths that only need about a millisecond
+	 *
+	 * A background thread started on first use copies steady_clock into a shared value every interval, so reads
+	 * may lag steady_clock by up to the interval plus scheduling delay. Shares steady_clock's epoch.
+	*/
+	struct coarse_clock
+	{
+		using rep = int64_t;
+		using period = std::nano;
+		using duration = nanoseconds;
+		using time_point = std::chrono::time_point<coarse_clock>;
+
+		constexpr static bool is_steady = true;
+
+		static time_point now() noexcept
+		{
+			return time_point{ duration{ impl::get_coarse_clock_ticker().load() } };
+		};
+
+		/**
+		 * @brief Changes how often the background thread refreshes the time, defaults to COARSE_CLOCK_INTERVAL_V
+		*/
+		static void set_interval(nanoseconds _interval)
+		{
+			impl::get_coarse_clock_ticker().set_interval(_interval);
+		};
+		static nanoseconds interval()
+		{
+			return impl::get_coarse_clock_ticker().interval();
+		};
+	};
+
+	enum class periodic_mode
+	{
+		// Runs on a fixed grid of deadlines, a late run does not push back the ones after it
+		fixed_rate,
+		// Waits a full period after each run finishes
+		fixed_delay
+	};
+
+	struct periodic_stats
+	{
+		// Number of runs
+		uint64_t ticks = 0;
+
+		// Deadlines skipped because a run finished after the next one had already passed
+		uint64_t overruns = 0;
+
+		// How late runs started compared to their deadline
+		duration max_jitter{ 0 };
+		duration total_jitter{ 0 };
+
+		duration mean_jitter() const noexcept
+		{
+			return (this->ticks == 0) ? duration{ 0 } : this->total_jitter / (typename duration::rep)this->ticks;
+		};
+	};
+
+	/**
+	 * @brief Thread that calls a function periodically using absolute deadlines on sae::clock()
+	 *
+	 * Replaces sleep loops that drift by however long the work takes. In fixed rate mode runs that fall behind
+	 * skip the missed deadlines rather than running back to back to catch up, each skipped deadline is counted as
+	 * an overrun. The first run happens immediately. Stopping wakes the thread at once instead of waiting out
+	 * the period.
+	*/
+	class periodic_ithread
+	{
+	public:
+		using function_type = std::function<void()>;
+
+		duration period() const noexcept { return this->period_; };
+		periodic_mode mode() const noexcept { return this->mode_; };
+
+		periodic_stats stats() const
+		{
+			std::unique_lock<std::mutex> _lck{ this->mtx_ };
+			return this->stats_;
+		};
+
+		bool is_running() const
+		{
+			std::unique_lock<std::mutex> _lck{ this->mtx_ };
+			return !this->stop_;
+		};
+
+		/**
+		 * @brief Stops the thread, waiting for a run in progress to finish
+		*/
+		void stop()
+		{
+			this->mtx_.lock();
+			this->stop_ = true;
+			this->mtx_.unlock();
+			this->cv_.notify_all();
+			this->thread_.shutdown();
+		};
+
+		periodic_ithread(duration _period, function_type _function, periodic_mode _mode = periodic_mode::fixed_rate) :
+			period_{ std::max(_period, duration{ 1 }) }, mode_{ _mode }, function_{ std::move(_function) },
+			thread_{ &periodic_ithread::run_main, this }
+		{};
+
+		periodic_ithread(const periodic_ithread& other) = delete;
+		periodic_ithread& operator=(const periodic_ithread& other) = delete;
+		periodic_ithread(periodic_ithread&& other) = delete;
+		periodic_ithread& operator=(periodic_ithread&& other) = delete;
+
+		~periodic_ithread()
+		{
+			this->stop();
+		};
+
+	private:
+		void run_main()
+		{
+			auto _deadline = clock().now();
+			std::unique_lock<std::mutex> _lck{ this->mtx_ };
+			while (!this->stop_)
+			{
+				if (this->cv_.wait_until(_lck, _deadline, [this]() { return this->stop_; }))
+				{
+					break;
+				};
+
+				const auto _jitter = std::max(clock().now() - _deadline, duration{ 0 });
+				_lck.unlock();
+				this->function_();
+				_lck.lock();
+
+				++this->stats_.ticks;
+				this->stats_.total_jitter += _jitter;
+				this->stats_.max_jitter = std::max(this->stats_.max_jitter, _jitter);
+
+				const auto _now = clock().now();
+				if (this->mode_ == periodic_mode::fixed_rate)
+				{
+					_deadline += this->period_;
+					if (_deadline <= _now)
+					{
+						const auto _missed = (_now - _deadline) / this->period_ + 1;
+						this->stats_.overruns += (uint64_t)_missed;
+						_deadline += this->period_ * _missed;
+					};
+				}
+				else
+				{
+					_deadline = _now + this->period_;
+				};
+			};
+		};
+
+		duration period_;
+		periodic_mode mode_;
+		function_type function_;
+		periodic_stats stats_{};
+		mutable std::mutex mtx_{};
+		std::condition_variable cv_{};
+		bool stop_ = false;
+
+		// Declared last so everything above exists before the thread starts
+		ithread thread_;
+
+	};
+
 	struct nolock_t {};
 	constexpr static nolock_t nolock{};
 
@@ -517,8 +861,8 @@ namespace sae
 	*/
 	static void redirect_thread_io(std::istream& _tin, std::ostream& _tout)
 	{
-		std::cout.set_rdbuf(_tin.rdbuf());
-		std::cin.set_rdbuf(_tout.rdbuf());
+		cin.rdbuf(_tin.rdbuf());
+		cout.rdbuf(_tout.rdbuf());
 	};
 
 };
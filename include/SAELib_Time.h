@@ -11,9 +11,23 @@
 #include <string_view>
 #include <array>
 #include <cstdint>
+#include <ratio>
+#include <limits>
 
 #include <ostream>
 
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)) && !defined(SAELIB_NO_TSC)
+#define SAELIB_TSC_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
+#else
+#define SAELIB_TSC_X86 0
+#endif
+
 namespace sae
 {
 
@@ -52,6 +66,150 @@ namespace sae
 
 
 
+};
+
+namespace sae
+{
+	namespace impl
+	{
+		/**
+		 * @brief Checks cpuid for a TSC that ticks at a constant rate through frequency and power state changes
+		*/
+		static bool has_invariant_tsc() noexcept
+		{
+#if SAELIB_TSC_X86
+#if defined(_MSC_VER)
+			int _regs[4]{};
+			__cpuid(_regs, 0x80000000);
+			if ((unsigned)_regs[0] < 0x80000007)
+			{
+				return false;
+			};
+			__cpuid(_regs, 0x80000007);
+			return (_regs[3] & (1 << 8)) != 0;
+#else
+			unsigned _eax = 0, _ebx = 0, _ecx = 0, _edx = 0;
+			if (!__get_cpuid(0x80000007, &_eax, &_ebx, &_ecx, &_edx))
+			{
+				return false;
+			};
+			return (_edx & (1u << 8)) != 0;
+#endif
+#else
+			return false;
+#endif
+		};
+
+		static uint64_t read_tsc() noexcept
+		{
+#if SAELIB_TSC_X86
+			return __rdtsc();
+#else
+			return 0;
+#endif
+		};
+
+		/**
+		 * @brief TSC rate measured against steady_clock the first time tsc_clock is used
+		*/
+		struct tsc_calibration
+		{
+			constexpr static uint32_t SHIFT_V = 32;
+			constexpr static std::chrono::milliseconds DURATION_V{ 10 };
+
+			bool usable = false;
+			uint64_t origin_tsc = 0;
+			int64_t origin_ns = 0;
+
+			// Nanoseconds per tick in 32.32 fixed point
+			uint64_t ns_per_tick = 0;
+
+			static int64_t steady_ns() noexcept
+			{
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			};
+
+			tsc_calibration() noexcept
+			{
+				if (!has_invariant_tsc())
+				{
+					return;
+				};
+
+				const auto _startNs = steady_ns();
+				const auto _startTsc = read_tsc();
+				auto _endNs = _startNs;
+				while (_endNs - _startNs < std::chrono::nanoseconds{ DURATION_V }.count())
+				{
+					_endNs = steady_ns();
+				};
+				const auto _endTsc = read_tsc();
+				if (_endTsc <= _startTsc)
+				{
+					return;
+				};
+
+				this->ns_per_tick = (uint64_t)(((long double)(_endNs - _startNs) * (long double)(1ull << SHIFT_V)) / (long double)(_endTsc - _startTsc));
+				this->origin_tsc = _endTsc;
+				this->origin_ns = _endNs;
+				this->usable = this->ns_per_tick != 0;
+			};
+
+			int64_t to_ns(uint64_t _tsc) const noexcept
+			{
+				const auto _ticks = _tsc - this->origin_tsc;
+#if defined(__SIZEOF_INT128__)
+				return this->origin_ns + (int64_t)(((unsigned __int128)_ticks * this->ns_per_tick) >> SHIFT_V);
+#else
+				const auto _high = (_ticks >> SHIFT_V) * this->ns_per_tick;
+				const auto _low = ((_ticks & 0xFFFFFFFFull) * this->ns_per_tick) >> SHIFT_V;
+				return this->origin_ns + (int64_t)(_high + _low);
+#endif
+			};
+
+			static const tsc_calibration& get() noexcept
+			{
+				static const tsc_calibration _calibration{};
+				return _calibration;
+			};
+		};
+	};
+
+	/**
+	 * @brief Clock that reads the CPU timestamp counter, a few nanoseconds per call instead of a vDSO call
+	 *
+	 * The counter is calibrated against steady_clock on first use, which takes about 10ms, and shares its epoch so
+	 * the two can be compared. Falls back to steady_clock when the CPU lacks an invariant TSC. Uses rdtsc without
+	 * serialization, so reads may be reordered with nearby instructions by a few cycles.
+	 * Can be used as SAE_THREAD_CLOCK_TYPE.
+	*/
+	struct tsc_clock
+	{
+		using rep = int64_t;
+		using period = std::nano;
+		using duration = std::chrono::nanoseconds;
+		using time_point = std::chrono::time_point<tsc_clock>;
+
+		constexpr static bool is_steady = true;
+
+		static time_point now() noexcept
+		{
+			const auto& _calibration = impl::tsc_calibration::get();
+			if (_calibration.usable) [[likely]]
+			{
+				return time_point{ duration{ _calibration.to_ns(impl::read_tsc()) } };
+			};
+			return time_point{ duration{ impl::tsc_calibration::steady_ns() } };
+		};
+
+		/**
+		 * @brief True if now() reads the TSC, false if it falls back to steady_clock
+		*/
+		static bool uses_tsc() noexcept
+		{
+			return impl::tsc_calibration::get().usable;
+		};
+	};
 };
 
 #ifndef SAE_THREAD_CLOCK_TYPE 
@@ -175,7 +333,7 @@ namespace sae
 		{
 			timestamp _out{};
 			_out.year = _time->tm_year + 1900;
-			_out.month = Month{ _time->tm_mon + 1 };
+			_out.month = Month{ _time->tm_mon };
 			_out.day = _time->tm_mday;
 			_out.hour = hours{ _time->tm_hour };
 			_out.min = minutes{ _time->tm_min };
@@ -245,12 +403,28 @@ namespace sae
 
 
 
+	namespace impl
+	{
+		/**
+		 * @brief Thread safe std::localtime
+		*/
+		static std::tm localtime(std::time_t _time) noexcept
+		{
+			std::tm _out{};
+#if defined(_WIN32)
+			localtime_s(&_out, &_time);
+#else
+			localtime_r(&_time, &_out);
+#endif
+			return _out;
+		};
+	};
+
 	template <cx_real_clock ClockT>
 	static timestamp local_timestamp(const ClockT& _clock = ClockT{})
 	{
-		const auto _ctime = _clock.to_time_t(_clock.now());
-		const auto _tlocal = std::localtime(&_ctime);
-		return timestamp{ _tlocal };
+		const auto _tlocal = impl::localtime(_clock.to_time_t(_clock.now()));
+		return timestamp{ &_tlocal };
 	};
 	
 	static timestamp local_timestamp()
@@ -260,6 +434,109 @@ namespace sae
 
 
 
+	/**
+	 * @brief Converts time_t values to local timestamps, only calling into the time zone database when the
+	 * local hour changes
+	 *
+	 * Time zone offsets only change on hour boundaries so minutes and seconds within the cached hour can be
+	 * derived from the difference to its start. Not thread safe, use cached_local_timestamp() for a per thread
+	 * instance.
+	*/
+	class local_timestamp_cache
+	{
+	public:
+		timestamp get(std::time_t _time) noexcept
+		{
+			if (_time < this->hour_begin_ || _time >= this->hour_begin_ + 3600)
+			{
+				const auto _tlocal = impl::localtime(_time);
+				this->hour_ = timestamp{ &_tlocal };
+				this->hour_begin_ = _time - (std::time_t)(_tlocal.tm_min * 60 + _tlocal.tm_sec);
+				this->hour_.min = minutes{ 0 };
+				this->hour_.sec = seconds{ 0 };
+			};
+
+			const auto _offset = (int)(_time - this->hour_begin_);
+			auto _out = this->hour_;
+			_out.min = minutes{ _offset / 60 };
+			_out.sec = seconds{ _offset % 60 };
+			return _out;
+		};
+
+		local_timestamp_cache() = default;
+
+	private:
+		timestamp hour_{};
+
+		// Start of the cached hour, the initial value forces a lookup on first use
+		std::time_t hour_begin_ = std::numeric_limits<std::time_t>::min();
+		
+	};
+
+	namespace impl
+	{
+		struct SAELib_Time_H_LocalTimestampCacheTag {};
+	};
+
+	/**
+	 * @brief Same as local_timestamp() but uses a per thread local_timestamp_cache
+	*/
+	template <cx_real_clock ClockT>
+	static timestamp cached_local_timestamp(const ClockT& _clock = ClockT{})
+	{
+		auto& _cache = get_singleton_thread_local<local_timestamp_cache, impl::SAELib_Time_H_LocalTimestampCacheTag>();
+		return _cache.get(_clock.to_time_t(_clock.now()));
+	};
+
+	static timestamp cached_local_timestamp()
+	{
+		return cached_local_timestamp<std::chrono::system_clock>();
+	};
+
+
+
+	// Length of "YYYY-MM-DDTHH:MM:SS"
+	constexpr static size_t ISO8601_LENGTH_V = 19;
+
+	using iso8601_buffer = std::array<char, ISO8601_LENGTH_V + 1>;
+
+	namespace impl
+	{
+		constexpr static char* write_digits(char* _at, unsigned _value, size_t _count) noexcept
+		{
+			for (size_t n = _count; n != 0; --n)
+			{
+				_at[n - 1] = (char)('0' + (_value % 10));
+				_value /= 10;
+			};
+			return _at + _count;
+		};
+	};
+
+	/**
+	 * @brief Formats a timestamp as "YYYY-MM-DDTHH:MM:SS" into a fixed buffer without allocating
+	 * @return View of the written characters, the buffer is also null terminated
+	*/
+	constexpr static std::string_view to_iso8601(const timestamp& _time, iso8601_buffer& _buffer) noexcept
+	{
+		auto _at = _buffer.data();
+		_at = impl::write_digits(_at, (unsigned)_time.year, 4);
+		*_at++ = '-';
+		_at = impl::write_digits(_at, (unsigned)_time.month + 1, 2);
+		*_at++ = '-';
+		_at = impl::write_digits(_at, (unsigned)_time.day, 2);
+		*_at++ = 'T';
+		_at = impl::write_digits(_at, (unsigned)_time.hour.count(), 2);
+		*_at++ = ':';
+		_at = impl::write_digits(_at, (unsigned)_time.min.count(), 2);
+		*_at++ = ':';
+		_at = impl::write_digits(_at, (unsigned)_time.sec.count(), 2);
+		*_at = '\0';
+		return std::string_view{ _buffer.data(), ISO8601_LENGTH_V };
+	};
+
+
+
 	
 
 };
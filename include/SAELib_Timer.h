@@ -2,8 +2,14 @@
 
 #include "SAELib_Time.h"
 
+#include "SAELib_Singleton.h"
+
 #include <concepts>
 #include <thread>
+#include <functional>
+#include <algorithm>
+#include <random>
+#include <cmath>
 
 namespace sae
 {
@@ -77,24 +83,30 @@ namespace sae
 		ivGood
 	};
 
+	/**
+	 * @brief Calls _op until it returns true or _duration has passed, waiting _duration / _attempts between tries
+	 * @return ivGood as soon as _op succeeds, ivTimeout if the deadline passes first
+	*/
 	template <sae::cx_clock ClockT, typename DurationT, typename Op> requires std::convertible_to<std::invoke_result_t<Op>, bool>
 	static bool invoke_with_timeout(ClockT _clock, DurationT _duration, Op _op, int _attempts = 10)
 	{
-		basic_timer<ClockT> _timer{ _duration, std::move(_clock) };
-		bool _out = ivTimeout;
-		_timer.start();
-		while (!_timer.finished())
+		using clock_duration = typename ClockT::duration;
+		const auto _deadline = _clock.now() + std::chrono::duration_cast<clock_duration>(_duration);
+		const auto _spacing = std::chrono::duration_cast<clock_duration>(_duration) / std::max(_attempts, 1);
+		while (true)
 		{
-			if (!std::invoke(_op))
+			if (std::invoke(_op))
 			{
-				std::this_thread::sleep_for(_timer.timer_duration() / _attempts);
-			}
-			else
+				return ivGood;
+			};
+
+			const auto _now = _clock.now();
+			if (_now >= _deadline)
 			{
-				_out = ivGood;
+				return ivTimeout;
 			};
+			std::this_thread::sleep_for(std::min<clock_duration>(_spacing, _deadline - _now));
 		};
-		return _out;
 	};
 
 	template <typename Op> requires std::convertible_to<std::invoke_result_t<Op>, bool>
@@ -103,4 +115,110 @@ namespace sae
 		return invoke_with_timeout(clock(), _duration, _op, _attempts);
 	};
 
+
+
+	/**
+	 * @brief Exponential backoff with jitter for retrying an operation
+	*/
+	struct retry_policy
+	{
+		// Wait before the second attempt, multiplied by multiplier after each failure up to max_delay
+		duration initial_delay = std::chrono::duration_cast<duration>(milliseconds{ 1 });
+		duration max_delay = std::chrono::duration_cast<duration>(seconds{ 1 });
+		double multiplier = 2.0;
+
+		// Fraction of each wait that is random, spreads out callers that failed at the same moment
+		double jitter = 0.5;
+
+		// Zero for no limit
+		int max_attempts = 10;
+
+		// Total time budget, no attempt is started after it runs out
+		duration timeout = duration::max();
+
+		/**
+		 * @brief Wait after the given failed attempt
+		 * @param _attempt One based number of the attempt that failed
+		 * @param _random Uniform random value in [0, 1)
+		*/
+		duration delay_after(int _attempt, double _random) const noexcept
+		{
+			const auto _scale = std::pow(this->multiplier, (double)std::max(_attempt - 1, 0));
+			const auto _base = std::min((double)this->initial_delay.count() * _scale, (double)this->max_delay.count());
+			const auto _jitter = std::clamp(this->jitter, 0.0, 1.0);
+			return duration{ (typename duration::rep)(_base * (1.0 - _jitter * _random)) };
+		};
+
+		bool out_of_attempts(int _attempts) const noexcept
+		{
+			return this->max_attempts > 0 && _attempts >= this->max_attempts;
+		};
+	};
+
+	struct retry_result
+	{
+		bool success = false;
+		int attempts = 0;
+
+		explicit operator bool() const noexcept { return this->success; };
+	};
+
+	namespace impl
+	{
+		struct retry_random
+		{
+			std::minstd_rand engine{ std::random_device{}() };
+
+			double next()
+			{
+				return std::uniform_real_distribution<double>{ 0.0, 1.0 }(this->engine);
+			};
+		};
+
+		struct SAELib_Timer_H_RetryRandomTag {};
+
+		static double retry_random_value()
+		{
+			return get_singleton_thread_local<retry_random, SAELib_Timer_H_RetryRandomTag>().next();
+		};
+	};
+
+	/**
+	 * @brief Calls _op until it returns true, the attempts run out, or the timeout passes, backing off between tries
+	*/
+	template <sae::cx_clock ClockT, typename Op> requires std::convertible_to<std::invoke_result_t<Op>, bool>
+	static retry_result invoke_with_retry(ClockT _clock, const retry_policy& _policy, Op _op)
+	{
+		const auto _start = _clock.now();
+		const auto _budget = std::chrono::duration_cast<typename ClockT::duration>(_policy.timeout);
+		retry_result _out{};
+		while (true)
+		{
+			++_out.attempts;
+			if (std::invoke(_op))
+			{
+				_out.success = true;
+				return _out;
+			};
+			if (_policy.out_of_attempts(_out.attempts))
+			{
+				return _out;
+			};
+
+			const auto _elapsed = _clock.now() - _start;
+			if (_elapsed >= _budget)
+			{
+				return _out;
+			};
+			const auto _delay = std::chrono::duration_cast<typename ClockT::duration>(_policy.delay_after(_out.attempts, impl::retry_random_value()));
+			std::this_thread::sleep_for(std::min<typename ClockT::duration>(_delay, _budget - _elapsed));
+		};
+	};
+
+	template <typename Op> requires std::convertible_to<std::invoke_result_t<Op>, bool>
+	static retry_result invoke_with_retry(const retry_policy& _policy, Op _op)
+	{
+		return invoke_with_retry(clock(), _policy, std::move(_op));
+	};
+
 }
\ No newline at end of file
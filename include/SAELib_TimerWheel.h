@@ -0,0 +1,525 @@
+#pragma once
+#ifndef SAELIB_TIMER_WHEEL_H
+#define SAELIB_TIMER_WHEEL_H
+
+#include "SAELib_Thread.h"
+#include "SAELib_Time.h"
+#include "SAELib_Timer.h"
+#include "SAELib_Memory.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <utility>
+
+namespace sae
+{
+	/**
+	 * @brief Identifies a scheduled timer, stays safe to use after the timer fires or is cancelled
+	*/
+	struct timer_handle
+	{
+		uint32_t index = UINT32_MAX;
+		uint32_t generation = 0;
+
+		explicit operator bool() const noexcept { return this->index != UINT32_MAX; };
+	};
+
+	/**
+	 * @brief Hierarchical timer wheel driven by hand, time is measured in ticks
+	 *
+	 * Four levels of 256 slots cover 2^32 ticks, timers further out are parked on the top level and placed again
+	 * when they come into range. Scheduling and cancelling are O(1), timers live in a node array and slots are
+	 * intrusive lists of node indices. Advancing one tick expires one slot and every 256^n ticks moves one slot of
+	 * level n down a level. Not thread safe, see timer_wheel for a wheel with its own thread.
+	*/
+	class basic_timer_wheel
+	{
+	public:
+		using callback_type = std::function<void()>;
+
+		constexpr static uint32_t SLOT_BITS_V = 8;
+		constexpr static uint32_t SLOTS_V = 1 << SLOT_BITS_V;
+		constexpr static uint32_t LEVELS_V = 4;
+		constexpr static uint64_t RANGE_V = 1ull << (SLOT_BITS_V * LEVELS_V);
+
+	private:
+		constexpr static uint32_t npos = UINT32_MAX;
+
+		struct node
+		{
+			callback_type callback{};
+			uint64_t deadline = 0;
+			uint32_t prev = npos;
+			uint32_t next = npos;
+			uint32_t slot = npos;
+			uint32_t generation = 0;
+		};
+
+		uint32_t acquire_node()
+		{
+			if (this->free_ == npos)
+			{
+				this->nodes_.emplace_back();
+				return (uint32_t)this->nodes_.size() - 1;
+			};
+			const auto _index = this->free_;
+			this->free_ = this->nodes_[_index].next;
+			return _index;
+		};
+		void release_node(uint32_t _index) noexcept
+		{
+			auto& _node = this->nodes_[_index];
+			_node.callback = nullptr;
+			_node.slot = npos;
+			++_node.generation;
+			_node.next = this->free_;
+			this->free_ = _index;
+		};
+
+		void link(uint32_t _index) noexcept
+		{
+			auto& _node = this->nodes_[_index];
+			const auto _delta = (_node.deadline > this->now_) ? _node.deadline - this->now_ : 0;
+
+			// Out of range timers wait in the last slot the top level reaches and get placed again from there
+			const auto _at = (_delta < RANGE_V) ? std::max(_node.deadline, this->now_) : this->now_ + RANGE_V - 1;
+			uint32_t _level = 0;
+			while (_level + 1 < LEVELS_V && (_at - this->now_) >> (SLOT_BITS_V * (_level + 1)) != 0)
+			{
+				++_level;
+			};
+
+			const auto _slot = _level * SLOTS_V + (uint32_t)((_at >> (SLOT_BITS_V * _level)) & (SLOTS_V - 1));
+			_node.slot = _slot;
+			_node.prev = npos;
+			_node.next = this->heads_[_slot];
+			if (_node.next != npos)
+			{
+				this->nodes_[_node.next].prev = _index;
+			};
+			this->heads_[_slot] = _index;
+		};
+		void unlink(uint32_t _index) noexcept
+		{
+			auto& _node = this->nodes_[_index];
+			if (_node.prev != npos)
+			{
+				this->nodes_[_node.prev].next = _node.next;
+			}
+			else
+			{
+				this->heads_[_node.slot] = _node.next;
+			};
+			if (_node.next != npos)
+			{
+				this->nodes_[_node.next].prev = _node.prev;
+			};
+		};
+
+		void cascade(uint32_t _level)
+		{
+			const auto _slot = _level * SLOTS_V + (uint32_t)((this->now_ >> (SLOT_BITS_V * _level)) & (SLOTS_V - 1));
+			auto _index = std::exchange(this->heads_[_slot], npos);
+			while (_index != npos)
+			{
+				const auto _next = this->nodes_[_index].next;
+				this->link(_index);
+				_index = _next;
+			};
+		};
+
+		template <typename SinkT>
+		void advance_one(SinkT& _sink)
+		{
+			++this->now_;
+
+			// Higher levels first so their timers can land in the lower slots cascaded on the same tick
+			uint32_t _top = 0;
+			while (_top + 1 < LEVELS_V && (this->now_ & ((1ull << (SLOT_BITS_V * (_top + 1))) - 1)) == 0)
+			{
+				++_top;
+			};
+			for (auto _level = _top; _level != 0; --_level)
+			{
+				this->cascade(_level);
+			};
+
+			// Pop one at a time so a callback may cancel the timers after it in the same slot
+			auto& _head = this->heads_[this->now_ & (SLOTS_V - 1)];
+			while (_head != npos)
+			{
+				const auto _index = _head;
+				this->unlink(_index);
+				auto _callback = std::move(this->nodes_[_index].callback);
+				this->release_node(_index);
+				--this->size_;
+				_sink(std::move(_callback));
+			};
+		};
+
+	public:
+		/**
+		 * @brief Current tick, starts at zero
+		*/
+		uint64_t now() const noexcept { return this->now_; };
+
+		/**
+		 * @brief Number of pending timers
+		*/
+		size_t size() const noexcept { return this->size_; };
+		bool empty() const noexcept { return this->size_ == 0; };
+
+		/**
+		 * @brief Ticks until the next tick that expires a timer or cascades one down a level, advancing by less
+		 * than this does nothing but move now() forward
+		 * @return Zero if no timers are pending
+		*/
+		uint64_t ticks_until_next() const noexcept
+		{
+			if (this->size_ == 0)
+			{
+				return 0;
+			};
+
+			uint64_t _out = UINT64_MAX;
+			for (uint64_t d = 1; d != SLOTS_V; ++d)
+			{
+				if (this->heads_[(this->now_ + d) & (SLOTS_V - 1)] != npos)
+				{
+					_out = d;
+					break;
+				};
+			};
+
+			// A slot on level n is cascaded on the first tick with its index in bits n and the bits below all zero
+			for (uint32_t _level = 1; _level != LEVELS_V; ++_level)
+			{
+				const auto _shift = SLOT_BITS_V * _level;
+				const auto _current = this->now_ >> _shift;
+				for (uint64_t k = 1; k <= SLOTS_V; ++k)
+				{
+					const auto _at = (_current + k) << _shift;
+					if (_at - this->now_ >= _out)
+					{
+						break;
+					};
+					if (this->heads_[_level * SLOTS_V + (uint32_t)((_current + k) & (SLOTS_V - 1))] != npos)
+					{
+						_out = _at - this->now_;
+						break;
+					};
+				};
+			};
+			return _out;
+		};
+
+		/**
+		 * @brief Schedules a callback to run once _ticks ticks from now, at least one tick
+		*/
+		timer_handle schedule(uint64_t _ticks, callback_type _callback)
+		{
+			const auto _index = this->acquire_node();
+			auto& _node = this->nodes_[_index];
+			_node.callback = std::move(_callback);
+			_node.deadline = this->now_ + std::max<uint64_t>(_ticks, 1);
+			this->link(_index);
+			++this->size_;
+			return timer_handle{ _index, _node.generation };
+		};
+
+		/**
+		 * @brief Checks if a timer is still waiting to fire
+		*/
+		bool pending(timer_handle _handle) const noexcept
+		{
+			return _handle.index < this->nodes_.size() &&
+				this->nodes_[_handle.index].generation == _handle.generation &&
+				this->nodes_[_handle.index].slot != npos;
+		};
+
+		/**
+		 * @brief Cancels a pending timer
+		 * @return False if the timer already fired or was cancelled
+		*/
+		bool cancel(timer_handle _handle) noexcept
+		{
+			if (!this->pending(_handle))
+			{
+				return false;
+			};
+			this->unlink(_handle.index);
+			this->release_node(_handle.index);
+			--this->size_;
+			return true;
+		};
+
+		/**
+		 * @brief Moves time forward, expired callbacks are handed to _sink instead of being called
+		*/
+		template <typename SinkT>
+		void advance(uint64_t _ticks, SinkT&& _sink)
+		{
+			for (; _ticks != 0 && this->size_ != 0; --_ticks)
+			{
+				this->advance_one(_sink);
+			};
+
+			// Nothing left to expire so the remaining ticks can be skipped
+			this->now_ += _ticks;
+		};
+
+		/**
+		 * @brief Moves time forward and runs the callbacks that expire
+		*/
+		void advance(uint64_t _ticks)
+		{
+			this->advance(_ticks, [](callback_type&& _callback) { _callback(); });
+		};
+
+		basic_timer_wheel()
+		{
+			this->heads_.fill(npos);
+		};
+
+	private:
+		std::vector<node> nodes_{};
+		std::array<uint32_t, SLOTS_V * LEVELS_V> heads_{};
+		uint32_t free_ = npos;
+		uint64_t now_ = 0;
+		size_t size_ = 0;
+
+	};
+
+	constexpr static milliseconds TIMER_WHEEL_RESOLUTION_V{ 1 };
+
+	/**
+	 * @brief Timer wheel with a thread that advances it in real time and runs the callbacks
+	 *
+	 * Callbacks run on the wheel thread without the lock held, so they may schedule or cancel timers. Timers are
+	 * rounded up to the next tick. The thread only wakes on ticks that expire or cascade a timer and sleeps while
+	 * no timers are pending.
+	*/
+	class timer_wheel
+	{
+	public:
+		using callback_type = basic_timer_wheel::callback_type;
+
+	private:
+		uint64_t ticks_at(time_point _time) const
+		{
+			if (_time <= this->start_)
+			{
+				return 0;
+			};
+			return (uint64_t)((_time - this->start_ + this->resolution_ - duration{ 1 }) / this->resolution_);
+		};
+		uint64_t elapsed_ticks() const
+		{
+			return (uint64_t)((clock().now() - this->start_) / this->resolution_);
+		};
+
+		void run_main()
+		{
+			std::vector<callback_type> _expired{};
+			std::unique_lock<std::mutex> _lck{ this->mtx_ };
+			while (!this->stop_)
+			{
+				if (this->wheel_.empty())
+				{
+					this->cv_.wait(_lck, [this]() { return this->stop_ || !this->wheel_.empty(); });
+					continue;
+				};
+
+				const auto _target = this->elapsed_ticks();
+				if (_target > this->wheel_.now())
+				{
+					this->wheel_.advance(_target - this->wheel_.now(), [&_expired](callback_type&& _callback)
+						{
+							_expired.push_back(std::move(_callback));
+						});
+
+					_lck.unlock();
+					for (auto& _callback : _expired)
+					{
+						_callback();
+					};
+					_expired.clear();
+					_lck.lock();
+					continue;
+				};
+
+				// Sleep through ticks with nothing in their slots, schedule_at() wakes the thread if it adds an earlier timer
+				this->wake_tick_ = this->wheel_.now() + this->wheel_.ticks_until_next();
+				this->cv_.wait_until(_lck, this->start_ + this->resolution_ * this->wake_tick_);
+				this->wake_tick_ = UINT64_MAX;
+			};
+		};
+
+	public:
+		duration resolution() const noexcept { return this->resolution_; };
+
+		size_t size() const
+		{
+			std::unique_lock<std::mutex> _lck{ this->mtx_ };
+			return this->wheel_.size();
+		};
+
+		/**
+		 * @brief Schedules a callback to run on the wheel thread at _time
+		*/
+		timer_handle schedule_at(time_point _time, callback_type _callback)
+		{
+			std::unique_lock<std::mutex> _lck{ this->mtx_ };
+
+			// An idle wheel has not been kept up to date, skip it ahead to now
+			const bool _wasEmpty = this->wheel_.empty();
+			if (_wasEmpty)
+			{
+				const auto _elapsed = this->elapsed_ticks();
+				if (_elapsed > this->wheel_.now())
+				{
+					this->wheel_.advance(_elapsed - this->wheel_.now());
+				};
+			};
+
+			const auto _at = std::max(this->ticks_at(_time), this->wheel_.now() + 1);
+			const auto _handle = this->wheel_.schedule(_at - this->wheel_.now(), std::move(_callback));
+			const bool _wake = _wasEmpty || _at < this->wake_tick_;
+			_lck.unlock();
+
+			if (_wake)
+			{
+				this->cv_.notify_one();
+			};
+			return _handle;
+		};
+
+		/**
+		 * @brief Schedules a callback to run on the wheel thread after _delay
+		*/
+		timer_handle schedule_after(duration _delay, callback_type _callback)
+		{
+			return this->schedule_at(clock().now() + _delay, std::move(_callback));
+		};
+
+		/**
+		 * @brief Cancels a pending timer
+		 * @return False if the timer already fired, is firing, or was cancelled
+		*/
+		bool cancel(timer_handle _handle)
+		{
+			std::unique_lock<std::mutex> _lck{ this->mtx_ };
+			return this->wheel_.cancel(_handle);
+		};
+
+		bool pending(timer_handle _handle) const
+		{
+			std::unique_lock<std::mutex> _lck{ this->mtx_ };
+			return this->wheel_.pending(_handle);
+		};
+
+		explicit timer_wheel(duration _resolution = TIMER_WHEEL_RESOLUTION_V) :
+			resolution_{ std::max(_resolution, duration{ 1 }) }, start_{ clock().now() },
+			thread_{ &timer_wheel::run_main, this }
+		{};
+
+		timer_wheel(const timer_wheel& other) = delete;
+		timer_wheel& operator=(const timer_wheel& other) = delete;
+		timer_wheel(timer_wheel&& other) = delete;
+		timer_wheel& operator=(timer_wheel&& other) = delete;
+
+		~timer_wheel()
+		{
+			this->mtx_.lock();
+			this->stop_ = true;
+			this->mtx_.unlock();
+			this->cv_.notify_all();
+			this->thread_.shutdown();
+		};
+
+	private:
+		duration resolution_;
+		time_point start_;
+		basic_timer_wheel wheel_{};
+		mutable std::mutex mtx_{};
+		std::condition_variable cv_{};
+		bool stop_ = false;
+
+		// Tick the thread is sleeping until, UINT64_MAX while it is awake or waiting for a first timer
+		uint64_t wake_tick_ = UINT64_MAX;
+
+		// Declared last so everything above exists before the thread starts
+		ithread thread_;
+
+	};
+
+	namespace impl
+	{
+		template <typename Op, typename DoneT>
+		struct async_retry_state : public ref_counted<async_retry_state<Op, DoneT>>
+		{
+			timer_wheel* wheel;
+			retry_policy policy;
+			Op op;
+			DoneT done;
+			time_point start;
+			retry_result result{};
+
+			async_retry_state(timer_wheel& _wheel, const retry_policy& _policy, Op&& _op, DoneT&& _done) :
+				wheel{ &_wheel }, policy{ _policy }, op{ std::move(_op) }, done{ std::move(_done) }, start{ clock().now() }
+			{};
+		};
+
+		template <typename Op, typename DoneT>
+		static void async_retry_attempt(const intrusive_ptr<async_retry_state<Op, DoneT>>& _state)
+		{
+			auto& _result = _state->result;
+			++_result.attempts;
+			if (std::invoke(_state->op))
+			{
+				_result.success = true;
+				std::invoke(_state->done, _result);
+				return;
+			};
+
+			const auto _elapsed = clock().now() - _state->start;
+			if (_state->policy.out_of_attempts(_result.attempts) || _elapsed >= _state->policy.timeout)
+			{
+				std::invoke(_state->done, _result);
+				return;
+			};
+
+			const auto _delay = std::min(_state->policy.delay_after(_result.attempts, retry_random_value()), _state->policy.timeout - _elapsed);
+			_state->wheel->schedule_after(_delay, [_state]()
+				{
+					async_retry_attempt(_state);
+				});
+		};
+	};
+
+	/**
+	 * @brief Retries _op with backoff on the wheel thread instead of blocking the caller
+	 *
+	 * Every attempt, including the first, runs on the wheel thread. Attempts still waiting when the wheel is
+	 * destroyed are dropped without calling _done.
+	 *
+	 * @param _done Called on the wheel thread with the retry_result once _op succeeds or the policy gives up
+	*/
+	template <typename Op, typename DoneT> requires std::convertible_to<std::invoke_result_t<Op&>, bool> && std::invocable<DoneT&, const retry_result&>
+	static void invoke_with_retry_async(timer_wheel& _wheel, const retry_policy& _policy, Op _op, DoneT _done)
+	{
+		auto _state = make_intrusive<impl::async_retry_state<Op, DoneT>>(_wheel, _policy, std::move(_op), std::move(_done));
+		_wheel.schedule_after(duration{ 0 }, [_state]()
+			{
+				impl::async_retry_attempt(_state);
+			});
+	};
+
+};
+
+#endif
@@ -2,11 +2,35 @@
 #ifndef SAELIB_TOKEN_H
 #define SAELIB_TOKEN_H
 
+#include "SAELib_Thread.h"
+
 #include <string_view>
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <cstring>
 #include <algorithm>
+#include <bit>
+#include <iterator>
+#include <ranges>
+#include <array>
+#include <deque>
+
+#if !defined(SAELIB_TOKEN_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#define SAELIB_TOKEN_SIMD_X86 true
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define SAELIB_TOKEN_SIMD_X86 false
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SAELIB_TOKEN_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SAELIB_TOKEN_TARGET_AVX2
+#endif
 
 namespace sae
 {
@@ -17,18 +41,172 @@ namespace sae
 
 	namespace impl
 	{
-		template <typename T, typename _Elem, typename _Traits>
-		static std::vector<std::string_view> split(const std::basic_string_view<_Elem, _Traits>& _str, const T& _token, size_t _tokenLen)
+		/**
+		 * @brief Calls _sink with each token of _str split on a delimiter string
+		*/
+		template <typename _Elem, typename _Traits, typename SinkT>
+		static void split_each(const std::basic_string_view<_Elem, _Traits>& _str, const std::basic_string_view<_Elem, _Traits>& _token, SinkT& _sink)
 		{
 			size_t _offset = 0;
 			size_t _atpos = 0;
-			std::vector<std::basic_string_view<_Elem, _Traits>> _tokens{};
-			while ((_atpos = _str.find(_token, _offset)) != std::basic_string_view<_Elem, _Traits>::npos)
+			if (!_token.empty())
+			{
+				while ((_atpos = _str.find(_token, _offset)) != std::basic_string_view<_Elem, _Traits>::npos)
+				{
+					_sink(_str.substr(_offset, _atpos - _offset));
+					_offset = _atpos + _token.size();
+				};
+			};
+			_sink(_str.substr(_offset));
+		};
+
+		template <typename SinkT>
+		using split_char_function = void(*)(std::string_view _str, char _delim, SinkT& _sink);
+
+		template <typename SinkT>
+		static void split_char_scalar(std::string_view _str, char _delim, SinkT& _sink)
+		{
+			auto _at = _str.data();
+			const auto _end = _at + _str.size();
+			while (auto _found = (const char*)std::memchr(_at, _delim, (size_t)(_end - _at)))
+			{
+				_sink(std::string_view{ _at, (size_t)(_found - _at) });
+				_at = _found + 1;
+			};
+			_sink(std::string_view{ _at, (size_t)(_end - _at) });
+		};
+
+#if SAELIB_TOKEN_SIMD_X86
+
+		// Sinks the token ending at each set bit of a block's delimiter mask
+		template <typename SinkT>
+		static inline void sink_masked_tokens(const char* _block, uint32_t _mask, const char*& _tokenBegin, SinkT& _sink)
+		{
+			while (_mask != 0)
+			{
+				const auto _delimAt = _block + std::countr_zero(_mask);
+				_sink(std::string_view{ _tokenBegin, (size_t)(_delimAt - _tokenBegin) });
+				_tokenBegin = _delimAt + 1;
+				_mask &= _mask - 1;
+			};
+		};
+
+		template <typename SinkT>
+		static inline void split_char_tail(const char* _at, const char* _end, char _delim, const char*& _tokenBegin, SinkT& _sink)
+		{
+			for (; _at != _end; ++_at)
+			{
+				if (*_at == _delim)
+				{
+					_sink(std::string_view{ _tokenBegin, (size_t)(_at - _tokenBegin) });
+					_tokenBegin = _at + 1;
+				};
+			};
+			_sink(std::string_view{ _tokenBegin, (size_t)(_end - _tokenBegin) });
+		};
+
+		template <typename SinkT>
+		static void split_char_sse2(std::string_view _str, char _delim, SinkT& _sink)
+		{
+			auto _at = _str.data();
+			const auto _end = _at + _str.size();
+			auto _tokenBegin = _at;
+
+			const auto _needle = _mm_set1_epi8(_delim);
+			for (; _end - _at >= 16; _at += 16)
+			{
+				const auto _block = _mm_loadu_si128((const __m128i*)_at);
+				const auto _mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_block, _needle));
+				sink_masked_tokens(_at, _mask, _tokenBegin, _sink);
+			};
+			split_char_tail(_at, _end, _delim, _tokenBegin, _sink);
+		};
+
+		template <typename SinkT>
+		SAELIB_TOKEN_TARGET_AVX2
+		static void split_char_avx2(std::string_view _str, char _delim, SinkT& _sink)
+		{
+			auto _at = _str.data();
+			const auto _end = _at + _str.size();
+			auto _tokenBegin = _at;
+
+			const auto _needle = _mm256_set1_epi8(_delim);
+			for (; _end - _at >= 32; _at += 32)
+			{
+				const auto _block = _mm256_loadu_si256((const __m256i*)_at);
+				const auto _mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_block, _needle));
+				sink_masked_tokens(_at, _mask, _tokenBegin, _sink);
+			};
+			split_char_tail(_at, _end, _delim, _tokenBegin, _sink);
+		};
+
+		static bool cpu_has_avx2() noexcept
+		{
+#if defined(_MSC_VER)
+			int _regs[4]{};
+			__cpuid(_regs, 1);
+			const bool _osxsave = (_regs[2] & (1 << 27)) != 0;
+			__cpuidex(_regs, 7, 0);
+			const bool _avx2 = (_regs[1] & (1 << 5)) != 0;
+			return _osxsave && _avx2 && ((_xgetbv(0) & 0x6) == 0x6);
+#else
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2");
+#endif
+		};
+
+#endif
+
+		template <typename SinkT>
+		static split_char_function<SinkT> select_split_char() noexcept
+		{
+#if SAELIB_TOKEN_SIMD_X86
+			return (cpu_has_avx2()) ? &split_char_avx2<SinkT> : &split_char_sse2<SinkT>;
+#else
+			return &split_char_scalar<SinkT>;
+#endif
+		};
+
+		/**
+		 * @brief Splits on a single character, scanning 16 or 32 bytes at a time where the cpu supports it
+		*/
+		template <typename SinkT>
+		static void split_char(std::string_view _str, char _delim, SinkT& _sink)
+		{
+			static const split_char_function<SinkT> _function = select_split_char<SinkT>();
+			_function(_str, _delim, _sink);
+		};
+
+		/**
+		 * @brief Calls _sink with each token of _str, single character delimiters take the vectorized path
+		*/
+		template <typename _Elem, typename _Traits, typename T, typename SinkT>
+		static void split_each(const std::basic_string_view<_Elem, _Traits>& _str, const T& _token, SinkT& _sink)
+		{
+			using string_view_type = std::basic_string_view<_Elem, _Traits>;
+			if constexpr (std::is_same_v<T, _Elem>)
+			{
+				if constexpr (std::is_same_v<string_view_type, std::string_view>)
+				{
+					split_char(_str, _token, _sink);
+				}
+				else
+				{
+					split_each(_str, string_view_type{ &_token, 1 }, _sink);
+				};
+			}
+			else
 			{
-				_tokens.push_back(_str.substr(_offset, _atpos - _offset));
-				_offset = _atpos + _tokenLen;
+				split_each(_str, string_view_type{ _token }, _sink);
 			};
-			_tokens.push_back(_str.substr(_offset));
+		};
+
+		template <typename T, typename _Elem, typename _Traits>
+		static basic_token_list<_Elem, _Traits> split(const std::basic_string_view<_Elem, _Traits>& _str, const T& _token)
+		{
+			basic_token_list<_Elem, _Traits> _tokens{};
+			auto _sink = [&_tokens](std::basic_string_view<_Elem, _Traits> _t) { _tokens.push_back(_t); };
+			split_each(_str, _token, _sink);
 			return _tokens;
 		};
 	};
@@ -36,17 +214,17 @@ namespace sae
 	template <typename _Elem, typename _Traits>
 	static basic_token_list<_Elem, _Traits> split(const std::basic_string_view<_Elem, _Traits>& _str, const _Elem _token)
 	{
-		return impl::split(_str, _token, 1);
+		return impl::split(_str, _token);
 	};
 	template <typename _Elem, typename _Traits>
 	static basic_token_list<_Elem, _Traits> split(const std::basic_string_view<_Elem, _Traits>& _str, const _Elem* _token)
 	{
-		return impl::split(_str, _token, std::strlen(_token));
+		return impl::split(_str, _token);
 	};
 	template <typename _Elem, typename _Traits>
 	static basic_token_list<_Elem, _Traits> split(const std::basic_string_view<_Elem, _Traits>& _str, const std::basic_string_view<_Elem, _Traits>& _token)
 	{
-		return impl::split(_str, _token, _token.size());
+		return impl::split(_str, _token);
 	};
 
 	template <typename _Elem, typename _Traits, typename _Alloc, typename T>
@@ -61,6 +239,436 @@ namespace sae
 		return std::erase_if(_tokens, [](const auto& _t) { return _t.empty(); });
 	};
 
+
+
+	/**
+	 * @brief Splits into an existing token list, it is cleared first but keeps its capacity so reusing it avoids allocating
+	*/
+	template <typename _Elem, typename _Traits, typename _Alloc, typename T>
+	static void split_into(const std::type_identity_t<std::basic_string_view<_Elem, _Traits>>& _str, const T& _token, basic_token_list<_Elem, _Traits, _Alloc>& _out)
+	{
+		_out.clear();
+		auto _sink = [&_out](std::basic_string_view<_Elem, _Traits> _t) { _out.push_back(_t); };
+		impl::split_each(_str, _token, _sink);
+	};
+
+	/**
+	 * @brief Splits into an output iterator
+	 * @return Output iterator one past the last token written
+	*/
+	template <typename _Elem, typename _Traits, typename T, typename OutIterT> requires std::output_iterator<OutIterT, std::basic_string_view<_Elem, _Traits>>
+	static OutIterT split_into(const std::basic_string_view<_Elem, _Traits>& _str, const T& _token, OutIterT _out)
+	{
+		auto _sink = [&_out](std::basic_string_view<_Elem, _Traits> _t) { *_out = _t; ++_out; };
+		impl::split_each(_str, _token, _sink);
+		return _out;
+	};
+
+	struct split_into_result
+	{
+		// Number of tokens written
+		size_t size = 0;
+
+		// True if there were more tokens than space for them, tokens past the end were dropped
+		bool overflow = false;
+	};
+
+	/**
+	 * @brief Splits into a fixed size array, any tokens that do not fit are dropped and reported as an overflow
+	*/
+	template <typename _Elem, typename _Traits, typename T, size_t N>
+	static split_into_result split_into(const std::type_identity_t<std::basic_string_view<_Elem, _Traits>>& _str, const T& _token, std::array<std::basic_string_view<_Elem, _Traits>, N>& _out)
+	{
+		split_into_result _result{};
+		auto _sink = [&_out, &_result](std::basic_string_view<_Elem, _Traits> _t)
+		{
+			if (_result.size != N)
+			{
+				_out[_result.size++] = _t;
+			}
+			else
+			{
+				_result.overflow = true;
+			};
+		};
+		impl::split_each(_str, _token, _sink);
+		return _result;
+	};
+
+	// Smallest piece of input worth handing to another thread in parallel_split()
+	constexpr static size_t PARALLEL_SPLIT_MIN_CHUNK_V = 1024 * 1024;
+
+	/**
+	 * @brief Splits a large string using multiple threads, gives the same tokens as split()
+	 * 
+	 * The input is cut into one chunk per thread just after a delimiter, each chunk is split on its own thread
+	 * and the results are joined back together in order.
+	 * 
+	 * @param _threads Number of threads to use, 0 uses the hardware concurrency
+	*/
+	template <typename _Elem, typename _Traits = std::char_traits<_Elem>>
+	static basic_token_list<_Elem, _Traits> parallel_split(const std::type_identity_t<std::basic_string_view<_Elem, _Traits>>& _str, const _Elem _token, size_t _threads = 0)
+	{
+		using string_view_type = std::basic_string_view<_Elem, _Traits>;
+
+		if (_threads == 0)
+		{
+			_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+		};
+		_threads = std::min(_threads, std::max<size_t>(_str.size() / PARALLEL_SPLIT_MIN_CHUNK_V, 1));
+		if (_threads == 1)
+		{
+			return split(_str, _token);
+		};
+
+		// Each boundary is placed just past a delimiter so no token is cut in half, if there are no delimiters
+		// left the current chunk runs to the end and the remaining chunks are dropped
+		std::vector<size_t> _bounds(_threads + 1, _str.size());
+		_bounds.front() = 0;
+		for (size_t n = 1; n != _threads; ++n)
+		{
+			const auto _guess = std::max(_str.size() / _threads * n, _bounds[n - 1]);
+			const auto _at = _str.find(_token, _guess);
+			if (_at == string_view_type::npos)
+			{
+				_threads = n;
+				_bounds.resize(n + 1);
+				break;
+			};
+			_bounds[n] = _at + 1;
+		};
+		if (_threads == 1)
+		{
+			return split(_str, _token);
+		};
+
+		std::vector<basic_token_list<_Elem, _Traits>> _results(_threads);
+		const auto _splitChunk = [&_str, &_bounds, &_results, _token, _threads](size_t _chunk)
+		{
+			auto& _tokens = _results[_chunk];
+			split_into(_str.substr(_bounds[_chunk], _bounds[_chunk + 1] - _bounds[_chunk]), _token, _tokens);
+			if (_chunk + 1 != _threads)
+			{
+				// Every chunk but the last ends on a delimiter, the empty token after it is the start of the next chunk
+				_tokens.pop_back();
+			};
+		};
+
+		{
+			std::vector<thread> _workers{};
+			_workers.reserve(_threads - 1);
+			for (size_t n = 1; n != _threads; ++n)
+			{
+				_workers.emplace_back(_splitChunk, n);
+			};
+			_splitChunk(0);
+			for (auto& _worker : _workers)
+			{
+				_worker.join();
+			};
+		};
+
+		size_t _total = 0;
+		for (const auto& _tokens : _results)
+		{
+			_total += _tokens.size();
+		};
+
+		basic_token_list<_Elem, _Traits> _out{};
+		_out.reserve(_total);
+		for (const auto& _tokens : _results)
+		{
+			_out.insert(_out.end(), _tokens.begin(), _tokens.end());
+		};
+		return _out;
+	};
+
+	/**
+	 * @brief Lazily split string, tokens are found as the view is iterated so nothing is allocated
+	 * 
+	 * Produces the same tokens as split(), or the same as split_not_empty() if skip empty is set.
+	*/
+	template <typename _Elem, typename _Traits = std::char_traits<_Elem>>
+	class basic_split_view : public std::ranges::view_interface<basic_split_view<_Elem, _Traits>>
+	{
+	public:
+		using string_view_type = std::basic_string_view<_Elem, _Traits>;
+
+		class iterator
+		{
+		public:
+			using iterator_concept = std::forward_iterator_tag;
+			using iterator_category = std::input_iterator_tag;
+			using value_type = string_view_type;
+			using difference_type = std::ptrdiff_t;
+
+			value_type operator*() const noexcept
+			{
+				return this->view_->str_.substr(this->begin_, this->end_ - this->begin_);
+			};
+
+			iterator& operator++()
+			{
+				do
+				{
+					this->next();
+				} while (!this->done_ && this->view_->skip_empty_ && this->begin_ == this->end_);
+				return *this;
+			};
+			iterator operator++(int)
+			{
+				auto _out = *this;
+				++(*this);
+				return _out;
+			};
+
+			friend inline bool operator==(const iterator& _lhs, const iterator& _rhs) noexcept
+			{
+				return _lhs.done_ == _rhs.done_ && (_lhs.done_ || _lhs.begin_ == _rhs.begin_);
+			};
+			friend inline bool operator==(const iterator& _lhs, std::default_sentinel_t) noexcept
+			{
+				return _lhs.done_;
+			};
+
+			iterator() = default;
+
+		private:
+			friend basic_split_view;
+
+			void find_end()
+			{
+				const auto& _view = *this->view_;
+				const auto _at = (_view.delim_len_ == 1) ?
+					_view.str_.find(_view.delim_ch_, this->begin_) :
+					_view.str_.find(_view.delim_str_, this->begin_);
+				this->last_ = (_at == string_view_type::npos || _view.delim_len_ == 0);
+				this->end_ = (this->last_) ? _view.str_.size() : _at;
+			};
+			void next()
+			{
+				if (this->last_)
+				{
+					this->done_ = true;
+				}
+				else
+				{
+					this->begin_ = this->end_ + this->view_->delim_len_;
+					this->find_end();
+				};
+			};
+
+			explicit iterator(const basic_split_view* _view) :
+				view_{ _view }, done_{ false }
+			{
+				this->find_end();
+				if (this->view_->skip_empty_ && this->begin_ == this->end_)
+				{
+					++(*this);
+				};
+			};
+
+			const basic_split_view* view_ = nullptr;
+			size_t begin_ = 0;
+			size_t end_ = 0;
+			bool last_ = false;
+			bool done_ = true;
+		};
+
+		iterator begin() const { return iterator{ this }; };
+		std::default_sentinel_t end() const noexcept { return std::default_sentinel; };
+
+		basic_split_view() = default;
+		basic_split_view(string_view_type _str, _Elem _delim, bool _skipEmpty = false) noexcept :
+			str_{ _str }, delim_ch_{ _delim }, delim_len_{ 1 }, skip_empty_{ _skipEmpty }
+		{};
+		basic_split_view(string_view_type _str, string_view_type _delim, bool _skipEmpty = false) noexcept :
+			str_{ _str }, delim_str_{ _delim }, delim_ch_{ (_delim.size() == 1) ? _delim.front() : _Elem{} },
+			delim_len_{ _delim.size() }, skip_empty_{ _skipEmpty }
+		{};
+
+	private:
+		string_view_type str_{};
+		string_view_type delim_str_{};
+		_Elem delim_ch_{};
+		size_t delim_len_ = 0;
+		bool skip_empty_ = false;
+	};
+
+	using split_view = basic_split_view<char>;
+
+	/**
+	 * @brief Set of single byte delimiters stored as a 256 bit lookup table
+	*/
+	class delimiter_set
+	{
+	public:
+		constexpr bool contains(char _c) const noexcept
+		{
+			const auto _byte = (uint8_t)_c;
+			return ((this->bits_[_byte / 64] >> (_byte % 64)) & 1) != 0;
+		};
+		constexpr void insert(char _c) noexcept
+		{
+			const auto _byte = (uint8_t)_c;
+			this->bits_[_byte / 64] |= (uint64_t{ 1 } << (_byte % 64));
+		};
+		constexpr void erase(char _c) noexcept
+		{
+			const auto _byte = (uint8_t)_c;
+			this->bits_[_byte / 64] &= ~(uint64_t{ 1 } << (_byte % 64));
+		};
+
+		constexpr delimiter_set() noexcept = default;
+		constexpr delimiter_set(std::string_view _delims) noexcept
+		{
+			for (auto& c : _delims)
+			{
+				this->insert(c);
+			};
+		};
+		constexpr delimiter_set(const char* _delims) noexcept :
+			delimiter_set{ std::string_view{ _delims } }
+		{};
+
+	private:
+		std::array<uint64_t, 4> bits_{};
+	};
+
+	constexpr static delimiter_set whitespace_delimiters_v{ " \t\r\n\v\f" };
+
+	/**
+	 * @brief Splits on any character in a delimiter set with support for quoted tokens and escaped characters
+	 * 
+	 * Runs of delimiters are treated as one, delimiters inside quotes are kept, and the escape character makes
+	 * the character after it literal. Set the quote or escape character to '\0' to disable it.
+	 * 
+	 * Tokens are views into the input string unless quotes or escapes had to be removed from the middle of them,
+	 * those are stored in the tokenizer and stay valid until it is used again.
+	*/
+	class tokenizer
+	{
+	public:
+		/**
+		 * @brief Tokenizes a string, replacing the contents of _out
+		*/
+		void tokenize_into(std::string_view _str, token_list& _out)
+		{
+			_out.clear();
+			this->unescaped_used_ = 0;
+
+			size_t _at = 0;
+			const auto _size = _str.size();
+			while (true)
+			{
+				while (_at != _size && this->delims_.contains(_str[_at]))
+				{
+					++_at;
+				};
+				if (_at == _size)
+				{
+					break;
+				};
+
+				const auto _begin = _at;
+				size_t _quotes = 0;
+				bool _escaped = false;
+				bool _inQuote = false;
+				for (; _at != _size; ++_at)
+				{
+					const auto c = _str[_at];
+					if (c == this->escape_ && this->escape_ != '\0')
+					{
+						_escaped = true;
+						if (_at + 1 != _size)
+						{
+							++_at;
+						};
+					}
+					else if (c == this->quote_ && this->quote_ != '\0')
+					{
+						_inQuote = !_inQuote;
+						++_quotes;
+					}
+					else if (!_inQuote && this->delims_.contains(c))
+					{
+						break;
+					};
+				};
+
+				const auto _token = _str.substr(_begin, _at - _begin);
+				if (!_escaped && _quotes == 0)
+				{
+					_out.push_back(_token);
+				}
+				else if (!_escaped && _quotes == 2 && _token.front() == this->quote_ && _token.back() == this->quote_)
+				{
+					_out.push_back(_token.substr(1, _token.size() - 2));
+				}
+				else
+				{
+					_out.push_back(this->unescape(_token));
+				};
+			};
+		};
+
+		/**
+		 * @brief Tokenizes a string
+		*/
+		token_list tokenize(std::string_view _str)
+		{
+			token_list _out{};
+			this->tokenize_into(_str, _out);
+			return _out;
+		};
+		token_list operator()(std::string_view _str)
+		{
+			return this->tokenize(_str);
+		};
+
+		const delimiter_set& delimiters() const noexcept { return this->delims_; };
+		char quote() const noexcept { return this->quote_; };
+		char escape() const noexcept { return this->escape_; };
+
+		tokenizer(delimiter_set _delims = whitespace_delimiters_v, char _quote = '"', char _escape = '\\') noexcept :
+			delims_{ _delims }, quote_{ _quote }, escape_{ _escape }
+		{};
+
+	private:
+		std::string_view unescape(std::string_view _token)
+		{
+			if (this->unescaped_used_ == this->unescaped_.size())
+			{
+				this->unescaped_.emplace_back();
+			};
+			auto& _out = this->unescaped_[this->unescaped_used_++];
+			_out.clear();
+			_out.reserve(_token.size());
+			for (size_t n = 0; n != _token.size(); ++n)
+			{
+				const auto c = _token[n];
+				if (c == this->escape_ && this->escape_ != '\0' && n + 1 != _token.size())
+				{
+					_out.push_back(_token[++n]);
+				}
+				else if (c != this->quote_ || this->quote_ == '\0')
+				{
+					_out.push_back(c);
+				};
+			};
+			return _out;
+		};
+
+		delimiter_set delims_;
+		char quote_;
+		char escape_;
+
+		// Deque so that growing it does not move the strings tokens are viewing, the strings are reused between
+		// calls so their capacity is only allocated once
+		std::deque<std::string> unescaped_{};
+		size_t unescaped_used_ = 0;
+	};
+
 	template <typename _Str, typename _Token> requires requires (const _Str& _cs, const _Token& _ctoken)
 	{
 		split(_cs, _ctoken);
@@ -5,6 +5,7 @@
 #include <type_traits>
 #include <concepts>
 #include <cstdint>
+#include <cstddef>
 #include <tuple>
 
 namespace sae
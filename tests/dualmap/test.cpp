@@ -0,0 +1,242 @@
+
+#include <SAELib_DualMap.h>
+
+#include <map>
+#include <string>
+#include <string_view>
+
+bool test_unordered_dualmap()
+{
+	sae::unordered_dualmap<std::string, int> _map
+	{
+		{ "one", 1 },
+		{ "two", 2 }
+	};
+
+	if (_map.ltor("one") != 1 || _map.rtol(2) != "two")
+		return false;
+	const auto& _cmap = _map;
+	if (_cmap.ltor("one") != 1 || _cmap.ltor(std::string_view{ "two" }) != 2 || _cmap.ltor(std::string{ "one" }) != 1)
+		return false;
+	if (!_map.contains_left("two") || _map.contains_right(3))
+		return false;
+
+	// Lookups with views must not need a temporary string
+	const std::string_view _view = "two";
+	if (!_map.contains_left(_view) || _map.ltor(_view) != 2)
+		return false;
+	if (const auto _found = _map.find_left(_view); !_found || *_found != 2)
+		return false;
+	if (_map.find_left(std::string_view{ "three" }) || _map.find_right(3))
+		return false;
+
+	_map.reserve(16);
+	if (!_map.emplace("three", 3) || _map.emplace("three", 4) || _map.emplace("four", 3))
+		return false;
+	if (_map.size() != 3 || _map.rtol(3) != "three" || _map.contains_left("four"))
+		return false;
+
+	return true;
+};
+
+bool test_dense_dualmap()
+{
+	sae::dense_dualmap<std::string, int> _map
+	{
+		{ "one", 1 },
+		{ "two", 2 }
+	};
+
+	if (_map.ltor("one") != 1 || _map.rtol(2) != "two")
+		return false;
+	if (_map.insert({ "one", 3 }) || _map.insert({ "three", 2 }))
+		return false;
+	if (!_map.emplace("three", 3) || _map.find_left(std::string_view{ "three" })->get() != 3)
+		return false;
+	if (_map.find_right(4) || _map.find_right(3)->get() != "three")
+		return false;
+
+	// Compare against std::map with enough churn to rehash and backward shift
+	_map.clear();
+	std::map<int, std::string> _expected{};
+	uint32_t _seed = 7;
+	const auto _random = [&_seed]() { _seed = _seed * 1103515245 + 12345; return (int)((_seed >> 16) % 2000); };
+
+	for (int n = 0; n != 5000; ++n)
+	{
+		const auto _key = _random();
+		const auto _str = std::to_string(_key) + "s";
+		if (n % 3 == 0)
+		{
+			const bool _erased = (n % 2 == 0) ? _map.erase_right(_key) : _map.erase_left(_str);
+			if (_erased != (_expected.erase(_key) != 0))
+				return false;
+		}
+		else
+		{
+			if (_map.insert({ _str, _key }) != _expected.insert({ _key, _str }).second)
+				return false;
+		};
+	};
+
+	if (_map.size() != _expected.size())
+		return false;
+	for (const auto& [_key, _str] : _expected)
+	{
+		if (_map.ltor(_str) != _key || _map.rtol(_key) != _str)
+			return false;
+	};
+	for (const auto& [_str, _key] : _map)
+	{
+		if (!_expected.contains(_key))
+			return false;
+	};
+
+	bool _threw = false;
+	try
+	{
+		_map.ltor("missing");
+	}
+	catch (const std::out_of_range&)
+	{
+		_threw = true;
+	};
+	return _threw;
+};
+
+namespace
+{
+	enum class phonetic
+	{
+		alpha,
+		bravo,
+		charlie,
+		delta,
+		echo,
+		foxtrot,
+		golf,
+		hotel,
+		india,
+		juliett,
+		kilo,
+		lima,
+		mike,
+		november,
+		oscar,
+		papa,
+		quebec,
+		romeo,
+		sierra,
+		tango,
+		uniform,
+		victor,
+		whiskey,
+		xray,
+		yankee,
+		zulu,
+	};
+
+	constexpr auto PHONETIC_V = sae::make_frozen_dualmap<phonetic>
+	({
+		{ "alpha", phonetic::alpha },
+		{ "bravo", phonetic::bravo },
+		{ "charlie", phonetic::charlie },
+		{ "delta", phonetic::delta },
+		{ "echo", phonetic::echo },
+		{ "foxtrot", phonetic::foxtrot },
+		{ "golf", phonetic::golf },
+		{ "hotel", phonetic::hotel },
+		{ "india", phonetic::india },
+		{ "juliett", phonetic::juliett },
+		{ "kilo", phonetic::kilo },
+		{ "lima", phonetic::lima },
+		{ "mike", phonetic::mike },
+		{ "november", phonetic::november },
+		{ "oscar", phonetic::oscar },
+		{ "papa", phonetic::papa },
+		{ "quebec", phonetic::quebec },
+		{ "romeo", phonetic::romeo },
+		{ "sierra", phonetic::sierra },
+		{ "tango", phonetic::tango },
+		{ "uniform", phonetic::uniform },
+		{ "victor", phonetic::victor },
+		{ "whiskey", phonetic::whiskey },
+		{ "xray", phonetic::xray },
+		{ "yankee", phonetic::yankee },
+		{ "zulu", phonetic::zulu }
+	});
+
+	static_assert(PHONETIC_V.ltor("kilo") == phonetic::kilo);
+	static_assert(PHONETIC_V.rtol(phonetic::zulu) == "zulu");
+	static_assert(!PHONETIC_V.contains_left("kilogram"));
+};
+
+bool test_frozen_dualmap()
+{
+	const char* const _words[] =
+	{
+		"alpha",
+		"bravo",
+		"charlie",
+		"delta",
+		"echo",
+		"foxtrot",
+		"golf",
+		"hotel",
+		"india",
+		"juliett",
+		"kilo",
+		"lima",
+		"mike",
+		"november",
+		"oscar",
+		"papa",
+		"quebec",
+		"romeo",
+		"sierra",
+		"tango",
+		"uniform",
+		"victor",
+		"whiskey",
+		"xray",
+		"yankee",
+		"zulu",
+	};
+
+	if (PHONETIC_V.size() != std::size(_words))
+		return false;
+
+	for (size_t n = 0; n != std::size(_words); ++n)
+	{
+		const auto _value = PHONETIC_V.find_left(std::string{ _words[n] });
+		if (!_value || *_value != phonetic(n))
+			return false;
+		if (PHONETIC_V.rtol(phonetic(n)) != _words[n])
+			return false;
+	};
+
+	if (PHONETIC_V.find_left("") || PHONETIC_V.find_right(phonetic(100)))
+		return false;
+
+	// Values with gaps fall back to a binary search
+	constexpr auto _sparse = sae::make_frozen_dualmap<int>({ { "ten", 10 }, { "one", 1 }, { "hundred", 100 } });
+	static_assert(_sparse.rtol(100) == "hundred");
+	if (_sparse.rtol(1) != "one" || _sparse.ltor("ten") != 10 || _sparse.contains_right(2))
+		return false;
+
+	// Empty maps, as generated for an enum with no values, build and miss every lookup
+	constexpr auto _empty = sae::make_frozen_dualmap<phonetic>();
+	static_assert(_empty.empty() && _empty.size() == 0 && _empty.begin() == _empty.end());
+	return !_empty.find_left("alpha") && !_empty.contains_right(phonetic(0));
+};
+
+int main()
+{
+	if (!test_unordered_dualmap())
+		return -1;
+	if (!test_dense_dualmap())
+		return -1;
+	if (!test_frozen_dualmap())
+		return -1;
+	return 0;
+};
@@ -0,0 +1,171 @@
+#include <SAELib_IO.h>
+#include <SAELib_Logging.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <thread>
+
+#if defined(SAELIB_IO_NO_URING)
+constexpr static std::string_view test_name_v = "saelib_io_test_pool";
+#else
+constexpr static std::string_view test_name_v = "saelib_io_test";
+#endif
+
+std::filesystem::path test_path(std::string_view _suffix)
+{
+	return std::filesystem::temp_directory_path() / (std::string{ test_name_v } + std::string{ _suffix });
+};
+
+std::string read_file(const std::filesystem::path& _path)
+{
+	std::ifstream _ifstr{ _path, std::ios::binary };
+	std::stringstream _sstr{};
+	_sstr << _ifstr.rdbuf();
+	return _sstr.str();
+};
+
+bool test_backend()
+{
+	const auto _backend = sae::get_io_context().backend();
+#if defined(SAELIB_IO_NO_URING)
+	return _backend == ((SAELIB_IO_POSIX) ? sae::io_backend::thread_pool : sae::io_backend::stream);
+#else
+	return _backend != sae::io_backend::stream || !SAELIB_IO_POSIX;
+#endif
+};
+
+bool test_drain()
+{
+	const auto _path = test_path("_drain.bin");
+
+	// Spans several drain chunks and does not end on a chunk boundary
+	std::string _contents{};
+	for (size_t n = 0; n != sae::IO_DRAIN_CHUNK_SIZE_V * 3 + 1234; ++n)
+	{
+		_contents.push_back((char)('a' + (n * 7) % 26));
+	};
+	{
+		std::ofstream _ofstr{ _path, std::ios::binary };
+		_ofstr << _contents;
+	};
+
+	const auto _chars = sae::drain<char>(_path);
+	if (std::string_view{ _chars.data(), _chars.size() } != _contents)
+		return false;
+
+	const auto _bytes = sae::drain(_path);
+	if (_bytes.size() != _contents.size() || (char)_bytes.back() != _contents.back())
+		return false;
+
+	// Batched reads at arbitrary offsets
+	sae::io_file _file{ _path };
+	std::vector<char> _a(100);
+	std::vector<char> _b(100);
+	std::array<sae::io_read_op, 2> _ops{};
+	_ops[0].buffer = std::as_writable_bytes(std::span<char>{ _a });
+	_ops[0].offset = 10;
+	_ops[1].buffer = std::as_writable_bytes(std::span<char>{ _b });
+	_ops[1].offset = sae::IO_DRAIN_CHUNK_SIZE_V * 2;
+	sae::get_io_context().read(_file, _ops);
+	if (_ops[0].result != 100 || _ops[1].result != 100 ||
+		std::string_view{ _a.data(), _a.size() } != std::string_view{ _contents }.substr(10, 100) ||
+		std::string_view{ _b.data(), _b.size() } != std::string_view{ _contents }.substr(sae::IO_DRAIN_CHUNK_SIZE_V * 2, 100))
+	{
+		return false;
+	};
+	_file.close();
+
+	std::filesystem::remove(_path);
+	return sae::drain(_path).empty();
+};
+
+bool test_writer()
+{
+	const auto _path = test_path("_writer.txt");
+	{
+		std::ofstream _ofstr{ _path };
+		_ofstr << "existing\n";
+	};
+
+	// Write mode truncates
+	{
+		sae::io_file_writer _writer{ _path, sae::io_mode::write };
+		_writer.write("first\n");
+	};
+	if (read_file(_path) != "first\n")
+		return false;
+
+	// Appends keep existing contents and interleave with other writers to the same file
+	{
+		sae::io_file_writer _a{ _path };
+		sae::io_file_writer _b{ _path };
+		_a.write("a\n");
+		if (!_a.flush())
+			return false;
+		_b.write("b\n");
+		if (!_b.flush())
+			return false;
+		_a.write("c\n");
+	};
+	if (read_file(_path) != "first\na\nb\nc\n")
+		return false;
+
+	// Larger than the buffer so it is written out in several flushes
+	std::string _big(sae::IO_WRITER_BUFFER_SIZE_V * 3 + 17, 'x');
+	{
+		sae::io_file_writer _writer{ _path, sae::io_mode::write };
+		for (size_t n = 0; n < _big.size(); n += 1000)
+		{
+			_writer.write(std::string_view{ _big }.substr(n, 1000));
+		};
+	};
+	if (read_file(_path) != _big)
+		return false;
+
+	std::filesystem::remove(_path);
+	return true;
+};
+
+bool test_file_logger()
+{
+	const auto _path = test_path("_logger.txt");
+	std::filesystem::remove(_path);
+	{
+		std::ofstream _ofstr{ _path };
+		_ofstr << "previous run\n";
+	};
+
+	// Used from a thread other than the one that made it, after that thread has exited
+	std::unique_ptr<sae::file_logger> _logger{};
+	std::thread{ [&_logger, &_path]() { _logger = std::make_unique<sae::file_logger>(_path); } }.join();
+	*_logger << sae::log_entry{ "info", "test", "hello" } << sae::endentry;
+
+	// Each entry is on disk as soon as it ends unless batching is turned on
+	if (read_file(_path) != "previous run\nLOG BEGIN\n(info)[test] hello\n")
+		return false;
+	_logger->set_batched(true);
+	std::thread{ [&_logger]() { *_logger << "from another thread" << sae::endentry; } }.join();
+	if (read_file(_path) != "previous run\nLOG BEGIN\n(info)[test] hello\n")
+		return false;
+	_logger.reset();
+
+	const auto _contents = read_file(_path);
+	std::filesystem::remove(_path);
+	return _contents == "previous run\nLOG BEGIN\n(info)[test] hello\nfrom another thread\n";
+};
+
+int main()
+{
+	if (!test_backend())
+		return -1;
+	if (!test_drain())
+		return -1;
+	if (!test_writer())
+		return -1;
+	if (!test_file_logger())
+		return -1;
+	return 0;
+};
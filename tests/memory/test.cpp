@@ -0,0 +1,268 @@
+
+#include <SAELib_Memory.h>
+#include <SAELib_SortedVector.h>
+#include <SAELib_Token.h>
+#include <SAELib_Logging.h>
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <fstream>
+#include <filesystem>
+#include <memory_resource>
+#include <thread>
+#include <atomic>
+
+bool test_arena()
+{
+	sae::arena _arena{ 1024 };
+
+	// Alignment is respected across chunk boundaries and oversized requests get their own chunk
+	for (size_t _align = 1; _align <= 64; _align *= 2)
+	{
+		const auto _ptr = _arena.allocate(100, _align);
+		if ((uintptr_t)_ptr % _align != 0)
+			return false;
+	};
+	const auto _big = (char*)_arena.allocate(4096);
+	std::fill(_big, _big + 4096, 'a');
+
+	struct point { int x; int y; };
+	const auto _point = _arena.make<point>(1, 2);
+	if (_point->x != 1 || _point->y != 2)
+		return false;
+
+	// Reset keeps the chunks for the next batch
+	const auto _capacity = _arena.capacity();
+	for (int n = 0; n != 10; ++n)
+	{
+		_arena.reset();
+		for (int m = 0; m != 40; ++m)
+		{
+			_arena.allocate(100);
+		};
+		if (_arena.capacity() != _capacity)
+			return false;
+	};
+
+	_arena.release();
+	return _arena.capacity() == 0;
+};
+
+bool test_arena_allocator()
+{
+	sae::arena _arena{};
+
+	sae::sorted_vector<int, std::less<int>, sae::arena_allocator<int>> _set{ sae::arena_allocator<int>{ _arena } };
+	_set.insert({ 5, 3, 9, 3, 1 });
+	if (_set.size() != 4 || *_set.begin() != 1)
+		return false;
+
+	using arena_token_list = sae::basic_token_list<char, std::char_traits<char>, sae::arena_allocator<std::string_view>>;
+	arena_token_list _tokens{ sae::arena_allocator<std::string_view>{ _arena } };
+	sae::split_into("a b c", ' ', _tokens);
+	if (_tokens.size() != 3 || _tokens[2] != "c")
+		return false;
+
+	sae::arena_resource _resource{ _arena };
+	std::pmr::vector<std::pmr::string> _strings{ &_resource };
+	_strings.emplace_back("a string long enough to skip the small string buffer");
+	return _strings.front().size() > 16;
+};
+
+bool test_arena_logging()
+{
+	const auto _path = std::filesystem::temp_directory_path() / "saelib_memory_test.log";
+	std::filesystem::remove(_path);
+
+	sae::arena _arena{};
+	sae::arena_resource _resource{ _arena };
+	{
+		sae::file_logger _logger{ _path };
+		std::pmr::string _message{ "arena message", &_resource };
+		_logger << _message << sae::endentry;
+		_logger << sae::log_entry{ "info", "test", "entry" } << sae::endentry;
+	};
+
+	std::ifstream _file{ _path };
+	std::string _line{};
+	std::vector<std::string> _lines{};
+	while (std::getline(_file, _line))
+	{
+		_lines.push_back(_line);
+	};
+	_file.close();
+	std::filesystem::remove(_path);
+
+	return _lines.size() == 3 && _lines[1] == "arena message" && _lines[2] == "(info)[test] entry";
+};
+
+bool test_object_pool()
+{
+	struct payload
+	{
+		int value;
+		std::string name;
+	};
+	using pool = sae::object_pool<payload>;
+
+	// Freed slots are reused first
+	auto _first = sae::pool_make_unique<payload>(1, "first");
+	const auto _address = _first.get();
+	_first.reset();
+	auto _second = sae::pool_make_unique<payload>(2, "second");
+	if (_second.get() != _address || _second->name != "second")
+		return false;
+	_second.reset();
+
+	// Allocate on one thread and free on another, the slots must flow back through the depot
+	constexpr size_t _count = sae::OBJECT_POOL_BATCH_SIZE_V * 8;
+	std::vector<payload*> _objects{};
+	for (size_t n = 0; n != _count; ++n)
+	{
+		_objects.push_back(pool::make((int)n, "object"));
+	};
+
+	size_t _sum = 0;
+	std::thread _freer{ [&_objects, &_sum]()
+		{
+			for (auto _ptr : _objects)
+			{
+				_sum += (size_t)_ptr->value;
+				pool::destroy(_ptr);
+			};
+			if (pool::cached() >= sae::OBJECT_POOL_BATCH_SIZE_V * 2)
+				_sum = 0;
+		} };
+	_freer.join();
+	if (_sum != _count * (_count - 1) / 2)
+		return false;
+
+	const auto _seen = std::unordered_set<payload*>{ _objects.begin(), _objects.end() };
+	size_t _reused = 0;
+	_objects.clear();
+	for (size_t n = 0; n != _count; ++n)
+	{
+		_objects.push_back(pool::make((int)n, "again"));
+		_reused += _seen.count(_objects.back());
+	};
+	for (auto _ptr : _objects)
+	{
+		pool::destroy(_ptr);
+	};
+	return _reused >= _count - sae::OBJECT_POOL_BATCH_SIZE_V * 2;
+};
+
+namespace
+{
+	int destroyed_v = 0;
+
+	struct shared_node : public sae::ref_counted<shared_node>
+	{
+		int value = 0;
+		sae::intrusive_ptr<shared_node> next{};
+
+		shared_node(int _value) : value{ _value } {};
+		~shared_node() { ++destroyed_v; };
+	};
+
+	struct local_node : public sae::ref_counted<local_node, sae::local_ref_count>
+	{
+		~local_node() { ++destroyed_v; };
+	};
+};
+
+bool test_intrusive_ptr()
+{
+	destroyed_v = 0;
+	{
+		auto _head = sae::make_intrusive<shared_node>(1);
+		_head->next = sae::make_intrusive<shared_node>(2);
+		auto _copy = _head;
+		if (_head->use_count() != 2 || _head != _copy)
+			return false;
+
+		// Copies on other threads share the count safely
+		std::vector<std::thread> _threads{};
+		for (int n = 0; n != 4; ++n)
+		{
+			_threads.emplace_back([_head]()
+				{
+					for (int m = 0; m != 1000; ++m)
+					{
+						auto _local = _head;
+						auto _next = _local->next;
+					};
+				});
+		};
+		for (auto& _thread : _threads)
+		{
+			_thread.join();
+		};
+		if (_head->use_count() != 2 || _head->next->use_count() != 1)
+			return false;
+
+		// Detach and adopt hands over a reference without touching the count
+		const auto _raw = _copy.detach();
+		sae::intrusive_ptr<shared_node> _adopted{ _raw, false };
+		if (_head->use_count() != 2 || _copy != nullptr)
+			return false;
+	};
+	if (destroyed_v != 2)
+		return false;
+
+	{
+		sae::intrusive_ptr<local_node> _node = sae::make_intrusive<local_node>();
+		auto _other = _node;
+		_node.reset();
+		if (_other->use_count() != 1 || destroyed_v != 2)
+			return false;
+	};
+	return destroyed_v == 3;
+};
+
+bool test_object_pool_late_free()
+{
+	struct late_tag {};
+	using pool = sae::object_pool<int, late_tag>;
+
+	// Constructed before the pool's cache on this thread so it is destroyed after it, like a static object
+	struct holder
+	{
+		void* ptr = nullptr;
+		~holder()
+		{
+			pool::deallocate(this->ptr);
+		};
+	};
+
+	void* _freed = nullptr;
+	std::thread{ [&_freed]()
+		{
+			thread_local holder _holder{};
+			_holder.ptr = pool::allocate();
+			_freed = _holder.ptr;
+		} }.join();
+
+	// The late free went straight to the depot, so it is the first slot handed out here
+	const auto _ptr = pool::allocate();
+	pool::deallocate(_ptr);
+	return _ptr == _freed;
+};
+
+int main()
+{
+	if (!test_arena())
+		return -1;
+	if (!test_arena_allocator())
+		return -1;
+	if (!test_arena_logging())
+		return -1;
+	if (!test_object_pool())
+		return -1;
+	if (!test_object_pool_late_free())
+		return -1;
+	if (!test_intrusive_ptr())
+		return -1;
+	return 0;
+};
@@ -0,0 +1,110 @@
+#include <SAELib_Profile.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+
+bool test_histogram_buckets()
+{
+	// Every bucket's range is contiguous with the next and values land in the bucket covering them
+	for (size_t n = 0; n + 1 != sae::impl::HISTOGRAM_BUCKET_COUNT_V; ++n)
+	{
+		if (sae::impl::histogram_bucket_high(n) + 1 != sae::impl::histogram_bucket_low(n + 1))
+			return false;
+	};
+	for (uint64_t _value : { 0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, ~0ull })
+	{
+		const auto _bucket = sae::impl::histogram_bucket(_value);
+		if (_value < sae::impl::histogram_bucket_low(_bucket) || _value > sae::impl::histogram_bucket_high(_bucket))
+			return false;
+	};
+	return sae::impl::histogram_bucket(~0ull) + 1 == sae::impl::HISTOGRAM_BUCKET_COUNT_V;
+};
+
+bool test_histogram_percentiles()
+{
+	sae::latency_histogram _histogram{};
+	if (_histogram.snapshot().p99() != 0)
+		return false;
+
+	for (uint64_t n = 1; n <= 10000; ++n)
+	{
+		_histogram.record(n);
+	};
+
+	const auto _snapshot = _histogram.snapshot();
+	const auto _near = [](uint64_t _got, uint64_t _expected)
+	{
+		return _got >= _expected && _got <= _expected + _expected / 32;
+	};
+	if (_snapshot.count() != 10000 || _snapshot.min() != 1 || _snapshot.max() != 10000)
+		return false;
+	if (!_near(_snapshot.p50(), 5000) || !_near(_snapshot.p99(), 9900) || !_near(_snapshot.p999(), 9990))
+		return false;
+	if (_snapshot.mean() != 5000.5)
+		return false;
+
+	std::ostringstream _ostr{};
+	_ostr << _snapshot;
+	if (_ostr.str().find("count=10000") != 0 || _ostr.str().find("100%") == std::string::npos)
+		return false;
+
+	_histogram.reset();
+	return _histogram.snapshot().count() == 0;
+};
+
+bool test_histogram_threads()
+{
+	sae::latency_histogram _histogram{};
+	std::vector<std::thread> _threads{};
+	for (int t = 0; t != 4; ++t)
+	{
+		_threads.emplace_back([&_histogram, t]()
+		{
+			for (int n = 0; n != 10000; ++n)
+			{
+				_histogram.record((uint64_t)(t * 10000 + n));
+			};
+		});
+	};
+	for (auto& _thread : _threads)
+	{
+		_thread.join();
+	};
+
+	const auto _snapshot = _histogram.snapshot();
+	return _snapshot.count() == 40000 && _snapshot.min() == 0 && _snapshot.max() == 39999;
+};
+
+bool test_scoped_timer()
+{
+	using namespace std::chrono_literals;
+
+	sae::latency_histogram _histogram{};
+	{
+		sae::scoped_timer<std::chrono::steady_clock> _timer{ _histogram };
+		std::this_thread::sleep_for(2ms);
+	};
+	{
+		sae::scoped_timer _timer{ _histogram };
+		_timer.cancel();
+	};
+
+	const auto _snapshot = _histogram.snapshot();
+	return _snapshot.count() == 1 && _snapshot.min() >= 2000000;
+};
+
+int main()
+{
+	if (!test_histogram_buckets())
+		return -1;
+	if (!test_histogram_percentiles())
+		return -1;
+	if (!test_histogram_threads())
+		return -1;
+	if (!test_scoped_timer())
+		return -1;
+	return 0;
+};
@@ -0,0 +1,120 @@
+#include <SAELib_RateLimit.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Clock that only moves when told to
+struct manual_clock
+{
+	using duration = std::chrono::milliseconds;
+	using rep = typename duration::rep;
+	using period = typename duration::period;
+	using time_point = std::chrono::time_point<manual_clock, duration>;
+	constexpr static bool is_steady = true;
+
+	static inline std::atomic<rep> now_{ 1000 };
+
+	static time_point now() noexcept { return time_point{ duration{ now_.load() } }; };
+	static void advance(rep _ms) noexcept { now_ += _ms; };
+};
+
+bool test_token_bucket()
+{
+	// 10 per second with a burst of 5
+	sae::token_bucket<manual_clock> _bucket{ 10.0, 5 };
+	if (_bucket.interval() != std::chrono::milliseconds{ 100 })
+		return false;
+
+	// Starts full
+	for (int n = 0; n != 5; ++n)
+	{
+		if (!_bucket.try_acquire())
+			return false;
+	};
+	if (_bucket.try_acquire())
+		return false;
+
+	// Refills one unit per interval, never beyond the burst size
+	manual_clock::advance(100);
+	if (!_bucket.try_acquire() || _bucket.try_acquire())
+		return false;
+	manual_clock::advance(10000);
+	if (!_bucket.try_acquire(5) || _bucket.try_acquire())
+		return false;
+
+	manual_clock::advance(250);
+	if (_bucket.try_acquire(3) || !_bucket.try_acquire(2))
+		return false;
+
+	// Could never be satisfied
+	return !_bucket.acquire(6);
+};
+
+bool test_leaky_bucket()
+{
+	sae::leaky_bucket<manual_clock> _bucket{ 10.0, 2 };
+
+	// No bursts, one unit per interval
+	if (!_bucket.try_acquire() || _bucket.try_acquire())
+		return false;
+	manual_clock::advance(50);
+	if (_bucket.try_acquire())
+		return false;
+	manual_clock::advance(50);
+	if (!_bucket.try_acquire())
+		return false;
+
+	// acquire() queues behind the unit in flight, turned away once the queue is longer than the capacity
+	manual_clock::advance(100);
+	if (!_bucket.try_acquire(3))
+		return false;
+	return !_bucket.acquire();
+};
+
+bool test_acquire_threads()
+{
+	using namespace std::chrono_literals;
+
+	// 4 threads taking 5 units each at 200 per second with a burst of 5 takes at least 75ms
+	sae::token_bucket<std::chrono::steady_clock> _tokens{ 200.0, 5 };
+	sae::leaky_bucket<std::chrono::steady_clock> _leaky{ 200.0, 64 };
+
+	const auto _run = [](auto& _bucket, std::chrono::milliseconds _minimum)
+	{
+		std::atomic<int> _taken{ 0 };
+		const auto _start = std::chrono::steady_clock::now();
+		std::vector<std::thread> _threads{};
+		for (int t = 0; t != 4; ++t)
+		{
+			_threads.emplace_back([&_bucket, &_taken]()
+			{
+				for (int n = 0; n != 5; ++n)
+				{
+					if (_bucket.acquire())
+					{
+						++_taken;
+					};
+				};
+			});
+		};
+		for (auto& _thread : _threads)
+		{
+			_thread.join();
+		};
+		return _taken == 20 && std::chrono::steady_clock::now() - _start >= _minimum;
+	};
+	return _run(_tokens, 70ms) && _run(_leaky, 90ms);
+};
+
+int main()
+{
+	if (!test_token_bucket())
+		return -1;
+	if (!test_leaky_bucket())
+		return -1;
+	if (!test_acquire_threads())
+		return -1;
+	return 0;
+};
@@ -0,0 +1,66 @@
+#include <SAELib_Singleton.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Slow constructor that counts how often it runs
+struct counted
+{
+	static inline std::atomic<int> constructed_{ 0 };
+	int value = 0;
+
+	counted()
+	{
+		++constructed_;
+		std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+		this->value = 42;
+	};
+};
+
+struct tag_a {};
+struct tag_b {};
+
+bool test_concurrent_construction()
+{
+	// Threads racing on first use all see the same fully constructed instance
+	std::vector<std::thread> _threads{};
+	std::atomic<int> _bad{ 0 };
+	for (int t = 0; t != 8; ++t)
+	{
+		_threads.emplace_back([&_bad]()
+		{
+			auto& _value = sae::get_singleton<counted, tag_a>();
+			const auto _ts = sae::get_singleton_threadsafe<counted, tag_a>();
+			std::unique_lock<sae::ThreadsafeSingleton<counted, tag_a>> _lck{ *_ts };
+			if (_value.value != 42 || (*_ts)->value != 42 || &_value != &sae::get_singleton<counted, tag_a>())
+			{
+				++_bad;
+			};
+		});
+	};
+	for (auto& _thread : _threads)
+	{
+		_thread.join();
+	};
+	return _bad == 0 && counted::constructed_ == 2;
+};
+
+bool test_thread_local()
+{
+	const auto _main = &sae::get_singleton_thread_local<int, tag_b>();
+	const int* _other = nullptr;
+	std::thread{ [&_other]() { _other = &sae::get_singleton_thread_local<int, tag_b>(); } }.join();
+	return _main == &sae::get_singleton_thread_local<int, tag_b>() && _other != _main &&
+		&sae::get_singleton<int, tag_a>() != &sae::get_singleton<int, tag_b>();
+};
+
+int main()
+{
+	if (!test_concurrent_construction())
+		return -1;
+	if (!test_thread_local())
+		return -1;
+	return 0;
+};
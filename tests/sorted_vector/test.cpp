@@ -0,0 +1,153 @@
+
+#include <SAELib_SortedVector.h>
+
+#include <set>
+#include <map>
+#include <string>
+#include <vector>
+
+bool test_sorted_vector()
+{
+	sae::sorted_vector<int> _vec{};
+	std::set<int> _expected{};
+
+	// Compare against std::set with a mix of single and bulk inserts and erases
+	uint32_t _seed = 42;
+	const auto _random = [&_seed]() { _seed = _seed * 1103515245 + 12345; return (int)((_seed >> 16) % 500); };
+
+	for (int n = 0; n != 200; ++n)
+	{
+		const auto _val = _random();
+		const auto _inserted = _vec.insert(_val).second;
+		if (_inserted != _expected.insert(_val).second)
+			return false;
+	};
+
+	std::vector<int> _bulk{};
+	for (int n = 0; n != 300; ++n)
+	{
+		_bulk.push_back(_random());
+	};
+	_vec.insert(_bulk.begin(), _bulk.end());
+	_expected.insert(_bulk.begin(), _bulk.end());
+
+	for (int n = 0; n != 100; ++n)
+	{
+		const auto _val = _random();
+		if (_vec.erase(_val) != _expected.erase(_val))
+			return false;
+	};
+
+	if (!std::equal(_vec.begin(), _vec.end(), _expected.begin(), _expected.end()))
+		return false;
+
+	for (int n = -1; n != 501; ++n)
+	{
+		if (_vec.contains(n) != _expected.contains(n))
+			return false;
+
+		const auto _lb = _vec.lower_bound(n);
+		const auto _elb = _expected.lower_bound(n);
+		if ((_lb == _vec.end()) != (_elb == _expected.end()))
+			return false;
+		if (_lb != _vec.end() && *_lb != *_elb)
+			return false;
+	};
+
+	// Edge cases the old bisection got wrong
+	sae::sorted_vector<int> _small{};
+	if (_small.lower_bound(1) != _small.end() || _small.contains(1))
+		return false;
+	_small.insert(5);
+	_small.insert(1);
+	_small.insert(9);
+	if (_small.container() != std::vector<int>{ 1, 5, 9 })
+		return false;
+	if (*_small.lower_bound(0) != 1 || _small.lower_bound(10) != _small.end())
+		return false;
+
+	sae::sorted_vector<int, std::greater<int>> _reversed{ 1, 3, 2, 3 };
+	if (_reversed.container() != std::vector<int>{ 3, 2, 1 })
+		return false;
+
+	return true;
+};
+
+bool test_flat_map()
+{
+	sae::flat_map<std::string, int> _map{ { "b", 2 }, { "a", 1 } };
+	std::map<std::string, int> _expected{ { "b", 2 }, { "a", 1 } };
+
+	_map["c"] = 3;
+	_expected["c"] = 3;
+	_map["a"] += 10;
+	_expected["a"] += 10;
+
+	if (_map.insert({ "a", 100 }).second)
+		return false;
+	_map.insert_or_assign("b", 20);
+	_expected.insert_or_assign("b", 20);
+
+	// Bulk insert keeps existing values over new duplicates
+	std::vector<std::pair<std::string, int>> _bulk{ { "e", 5 }, { "d", 4 }, { "a", -1 }, { "e", -5 } };
+	_map.insert(_bulk.begin(), _bulk.end());
+	_expected.insert(_bulk.begin(), _bulk.end());
+
+	if (_map.erase("c") != 1 || _map.erase("c") != 0)
+		return false;
+	_expected.erase("c");
+
+	if (_map.size() != _expected.size())
+		return false;
+	for (const auto& [_key, _value] : _expected)
+	{
+		if (!_map.contains(_key) || _map.at(_key) != _value)
+			return false;
+	};
+	if (_map.find("z") != _map.end())
+		return false;
+
+	return std::is_sorted(_map.begin(), _map.end());
+};
+
+bool test_eytzinger_set()
+{
+	for (int _size = 0; _size != 70; ++_size)
+	{
+		sae::sorted_vector<int> _vec{};
+		for (int n = 0; n != _size; ++n)
+		{
+			_vec.insert(n * 3);
+		};
+
+		const auto _frozen = _vec.freeze();
+		if (_frozen.size() != _vec.size())
+			return false;
+
+		for (int _key = -2; _key <= _size * 3 + 2; ++_key)
+		{
+			const auto _expected = _vec.lower_bound(_key);
+			const auto _found = _frozen.lower_bound(_key);
+			if ((_expected == _vec.end()) != (_found == nullptr))
+				return false;
+			if (_found && *_found != *_expected)
+				return false;
+			if (_frozen.contains(_key) != _vec.contains(_key))
+				return false;
+		};
+	};
+
+	return true;
+};
+
+int main()
+{
+	if (!test_sorted_vector())
+		return -1;
+	if (!test_flat_map())
+		return -1;
+	if (!test_eytzinger_set())
+		return -1;
+
+	return 0;
+};
@@ -0,0 +1,50 @@
+
+#include <SAELib_Stream.h>
+
+#include <sstream>
+#include <string>
+
+int main()
+{
+	std::string _data{};
+	for (int i = 0; i < 100000; ++i)
+	{
+		_data.push_back('a' + (i % 26));
+	};
+
+	// Read the whole stream back through chunks of varying sizes
+	for (size_t _chunkSize : { 1, 7, 4096, 100000, 200000 })
+	{
+		std::istringstream _istr{ _data };
+		sae::chunked_reader _reader{ _istr, _chunkSize, 3 };
+
+		std::string _out{};
+		while (auto _chunk = _reader.next())
+		{
+			if (_chunk->size() > _chunkSize)
+				return -1;
+			_out.append((const char*)_chunk->data(), _chunk->size());
+		};
+
+		if (_out != _data || !_reader.eof())
+			return -1;
+	};
+
+	// Empty stream should produce no chunks
+	{
+		std::istringstream _istr{};
+		sae::chunked_reader _reader{ _istr, 16 };
+		if (_reader.next())
+			return -1;
+	};
+
+	// Destroying the reader before the stream is drained
+	{
+		std::istringstream _istr{ _data };
+		sae::chunked_reader _reader{ _istr, 16 };
+		if (!_reader.next())
+			return -1;
+	};
+
+	return 0;
+};
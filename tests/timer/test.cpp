@@ -0,0 +1,347 @@
+
+#include <SAELib_TimerWheel.h>
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+bool test_basic_timer_wheel()
+{
+	sae::basic_timer_wheel _wheel{};
+
+	// Every timer must fire on exactly its deadline tick, including ones that cascade down from upper levels
+	uint32_t _seed = 11;
+	const auto _random = [&_seed]() { _seed = _seed * 1103515245 + 12345; return (uint64_t)(_seed >> 8); };
+
+	size_t _fired = 0;
+	bool _onTime = true;
+	std::vector<sae::timer_handle> _handles{};
+	for (int n = 0; n != 2000; ++n)
+	{
+		const auto _ticks = 1 + _random() % 100000;
+		const auto _deadline = _wheel.now() + _ticks;
+		_handles.push_back(_wheel.schedule(_ticks, [&_wheel, &_fired, &_onTime, _deadline]()
+			{
+				_onTime = _onTime && _wheel.now() == _deadline;
+				++_fired;
+			}));
+		_wheel.advance(_random() % 50);
+	};
+
+	size_t _cancelled = 0;
+	for (size_t n = 0; n < _handles.size(); n += 3)
+	{
+		_cancelled += (_wheel.cancel(_handles[n])) ? 1 : 0;
+	};
+	if (_wheel.size() + _fired + _cancelled != _handles.size())
+		return false;
+
+	// Cancelling twice or after firing does nothing
+	if (_wheel.cancel(_handles[0]))
+		return false;
+
+	_wheel.advance(200000);
+	if (!_onTime || _fired + _cancelled != _handles.size() || !_wheel.empty())
+		return false;
+
+	// Callbacks may schedule more timers
+	int _chain = 0;
+	std::function<void()> _next{};
+	_next = [&_wheel, &_chain, &_next]()
+	{
+		if (++_chain != 5)
+			_wheel.schedule(300, _next);
+	};
+	_wheel.schedule(1, _next);
+	_wheel.advance(2000);
+	if (_chain != 5 || _wheel.pending(_handles[1]))
+		return false;
+
+	// Jumping straight to ticks_until_next() never steps over a timer and far off timers take few jumps
+	uint64_t _jumpTo = 0;
+	size_t _jumps = 0;
+	_fired = 0;
+	for (uint64_t _ticks : { 3ull, 700ull, 70000ull, 20000000ull, 5000000000ull })
+	{
+		const auto _deadline = _wheel.now() + _ticks;
+		_wheel.schedule(_ticks, [&_wheel, &_fired, &_onTime, &_jumpTo, _deadline]()
+			{
+				_onTime = _onTime && _wheel.now() == _deadline && _wheel.now() == _jumpTo;
+				++_fired;
+			});
+	};
+	while (!_wheel.empty())
+	{
+		const auto _ticks = _wheel.ticks_until_next();
+		_jumpTo = _wheel.now() + _ticks;
+		_wheel.advance(_ticks);
+		++_jumps;
+	};
+	return _onTime && _fired == 5 && _jumps < 40 && _wheel.ticks_until_next() == 0;
+};
+
+bool test_timer_wheel()
+{
+	using namespace std::chrono_literals;
+
+	sae::timer_wheel _wheel{ 1ms };
+	std::atomic<int> _fired{ 0 };
+	std::atomic<int> _order{ 0 };
+	std::atomic<int> _firstOrder{ -1 };
+	std::atomic<int> _secondOrder{ -1 };
+
+	_wheel.schedule_after(30ms, [&]() { _secondOrder = _order++; ++_fired; });
+	_wheel.schedule_after(10ms, [&]() { _firstOrder = _order++; ++_fired; });
+	const auto _cancelled = _wheel.schedule_after(20ms, [&]() { ++_fired; });
+	if (!_wheel.cancel(_cancelled))
+		return false;
+
+	const auto _start = std::chrono::steady_clock::now();
+	while (_fired != 2 && std::chrono::steady_clock::now() - _start < 5s)
+	{
+		std::this_thread::sleep_for(1ms);
+	};
+	std::this_thread::sleep_for(30ms);
+
+	return _fired == 2 && _firstOrder == 0 && _secondOrder == 1 && _wheel.size() == 0;
+};
+
+bool test_retry()
+{
+	using namespace std::chrono_literals;
+
+	// Success returns at once instead of waiting out the whole timeout
+	const auto _start = std::chrono::steady_clock::now();
+	int _calls = 0;
+	if (sae::invoke_with_timeout(sae::duration{ 5s }, [&_calls]() { return ++_calls == 3; }, 1000) != sae::ivGood)
+		return false;
+	if (_calls != 3 || std::chrono::steady_clock::now() - _start > 1s)
+		return false;
+
+	if (sae::invoke_with_timeout(sae::duration{ 20ms }, []() { return false; }) != sae::ivTimeout)
+		return false;
+
+	sae::retry_policy _policy{};
+	_policy.initial_delay = 1ms;
+	_policy.max_delay = 4ms;
+	_policy.max_attempts = 5;
+
+	// Backoff doubles up to the cap and jitter only ever shortens the wait
+	if (_policy.delay_after(1, 0.0) != sae::duration{ 1ms } || _policy.delay_after(4, 0.0) != sae::duration{ 4ms })
+		return false;
+	if (_policy.delay_after(2, 0.99) < sae::duration{ 1ms } || _policy.delay_after(2, 0.99) > sae::duration{ 2ms })
+		return false;
+
+	_calls = 0;
+	auto _result = sae::invoke_with_retry(_policy, [&_calls]() { return ++_calls == 3; });
+	if (!_result || _result.attempts != 3)
+		return false;
+
+	_result = sae::invoke_with_retry(_policy, []() { return false; });
+	if (_result || _result.attempts != 5)
+		return false;
+
+	// The async variant never blocks the caller and reports back on the wheel thread
+	sae::timer_wheel _wheel{};
+	std::atomic<int> _asyncCalls{ 0 };
+	std::atomic<int> _asyncAttempts{ 0 };
+	std::atomic<bool> _asyncDone{ false };
+	sae::invoke_with_retry_async(_wheel, _policy, [&_asyncCalls]() { return ++_asyncCalls == 4; },
+		[&](const sae::retry_result& _res)
+		{
+			_asyncAttempts = (_res) ? _res.attempts : -1;
+			_asyncDone = true;
+		});
+
+	const auto _asyncStart = std::chrono::steady_clock::now();
+	while (!_asyncDone && std::chrono::steady_clock::now() - _asyncStart < 5s)
+	{
+		std::this_thread::sleep_for(1ms);
+	};
+	return _asyncDone && _asyncAttempts == 4;
+};
+
+bool test_tsc_clock()
+{
+	using namespace std::chrono_literals;
+	static_assert(sae::cx_clock<sae::tsc_clock>);
+
+	auto _last = sae::tsc_clock::now();
+	for (int n = 0; n != 100000; ++n)
+	{
+		const auto _now = sae::tsc_clock::now();
+		if (_now < _last)
+			return false;
+		_last = _now;
+	};
+
+	// Measures roughly the same interval as steady_clock, the bound only catches a badly wrong calibration as
+	// preemption between the reads shows up as error too
+	const auto _steadyStart = std::chrono::steady_clock::now();
+	const auto _tscStart = sae::tsc_clock::now();
+	std::this_thread::sleep_for(50ms);
+	const auto _tscElapsed = sae::tsc_clock::now() - _tscStart;
+	const auto _steadyElapsed = std::chrono::steady_clock::now() - _steadyStart;
+	const auto _error = (_tscElapsed > _steadyElapsed) ? _tscElapsed - _steadyElapsed : _steadyElapsed - _tscElapsed;
+	if (_error > std::max<std::chrono::steady_clock::duration>(_steadyElapsed / 4, 25ms))
+		return false;
+
+	sae::basic_timer<sae::tsc_clock> _timer{ 1ms };
+	_timer.start();
+	std::this_thread::sleep_for(2ms);
+	return _timer.finished();
+};
+
+bool test_coarse_clock()
+{
+	using namespace std::chrono_literals;
+	static_assert(sae::cx_clock<sae::coarse_clock>);
+
+	sae::coarse_clock::set_interval(1ms);
+	if (sae::coarse_clock::interval() != 1ms)
+		return false;
+
+	// Follows steady_clock, lagging by the interval plus however long the ticker waits to be scheduled, so
+	// the lag bound is generous and advancing is waited for rather than expected by a fixed time
+	const auto _start = sae::coarse_clock::now();
+	std::this_thread::sleep_for(30ms);
+	const auto _steady = std::chrono::steady_clock::now().time_since_epoch();
+	const auto _coarse = sae::coarse_clock::now().time_since_epoch();
+	if (_coarse > _steady || _steady - _coarse > 100ms)
+		return false;
+
+	const auto _giveUp = std::chrono::steady_clock::now() + 1s;
+	while (sae::coarse_clock::now() - _start < 10ms)
+	{
+		if (std::chrono::steady_clock::now() > _giveUp)
+			return false;
+		std::this_thread::sleep_for(1ms);
+	};
+	return true;
+};
+
+bool test_precise_sleep()
+{
+	using namespace std::chrono_literals;
+
+	std::vector<sae::duration> _late{};
+	for (int n = 0; n != 21; ++n)
+	{
+		const auto _deadline = sae::clock().now() + 2ms;
+		sae::precise_sleep_until(_deadline);
+		_late.push_back(sae::clock().now() - _deadline);
+		if (_late.back() < sae::duration{ 0 })
+			return false;
+	};
+
+	// Only waking early is an error, lateness depends on the machine so the median is just kept sane
+	std::sort(_late.begin(), _late.end());
+	return _late[_late.size() / 2] < 5ms;
+};
+
+bool test_periodic_ithread()
+{
+	using namespace std::chrono_literals;
+
+	// Work shorter than the period does not stretch it, and late wakeups never make it run more than once
+	// per period of the time it was actually running for
+	std::atomic<int> _runs{ 0 };
+	const auto _runStart = std::chrono::steady_clock::now();
+	auto _runTime = std::chrono::steady_clock::duration{};
+	{
+		sae::periodic_ithread _periodic{ 10ms, [&_runs]() { ++_runs; std::this_thread::sleep_for(3ms); } };
+		std::this_thread::sleep_for(105ms);
+		_periodic.stop();
+		_runTime = std::chrono::steady_clock::now() - _runStart;
+		if (_periodic.is_running())
+			return false;
+
+		const auto _stats = _periodic.stats();
+		if (_stats.ticks != (uint64_t)_runs.load() || _stats.max_jitter < _stats.mean_jitter())
+			return false;
+	};
+	if (_runs < 3 || _runs > _runTime / 10ms + 2)
+		return false;
+
+	// Work longer than the period skips deadlines instead of bursting
+	{
+		sae::periodic_ithread _periodic{ 5ms, []() { std::this_thread::sleep_for(12ms); } };
+		std::this_thread::sleep_for(60ms);
+		_periodic.stop();
+		if (_periodic.stats().overruns == 0)
+			return false;
+	};
+
+	// Stopping does not wait out a long period
+	const auto _start = std::chrono::steady_clock::now();
+	{
+		sae::periodic_ithread _periodic{ 10s, []() {}, sae::periodic_mode::fixed_delay };
+		std::this_thread::sleep_for(5ms);
+	};
+	return std::chrono::steady_clock::now() - _start < 1s;
+};
+
+bool test_local_timestamp()
+{
+	constexpr auto _iso = []()
+	{
+		sae::timestamp _time{};
+		_time.year = 2024;
+		_time.month = sae::Month::March;
+		_time.day = 7;
+		_time.hour = sae::hours{ 9 };
+		_time.min = sae::minutes{ 5 };
+		_time.sec = sae::seconds{ 42 };
+		sae::iso8601_buffer _buffer{};
+		return sae::to_iso8601(_time, _buffer) == "2024-03-07T09:05:42";
+	};
+	static_assert(_iso());
+
+	// Cached lookups match localtime across several hours, including going backwards
+	sae::local_timestamp_cache _cache{};
+	const std::time_t _base = std::time(nullptr);
+	for (std::time_t t = -3 * 3600; t < 3 * 3600; t += 37)
+	{
+		const auto _time = (t % 2 == 0) ? _base + t : _base - t;
+		const auto _tm = sae::impl::localtime(_time);
+		const auto _expected = sae::timestamp{ &_tm };
+		const auto _got = _cache.get(_time);
+
+		sae::iso8601_buffer _a{};
+		sae::iso8601_buffer _b{};
+		if (sae::to_iso8601(_got, _a) != sae::to_iso8601(_expected, _b) ||
+			_got.weekday != _expected.weekday || _got.yearday != _expected.yearday || _got.dst != _expected.dst)
+		{
+			return false;
+		};
+	};
+
+	const auto _tnow = std::time(nullptr);
+	const auto _tm = sae::impl::localtime(_tnow);
+	if (sae::local_timestamp().month != sae::Month{ _tm.tm_mon } || sae::cached_local_timestamp().month != sae::Month{ _tm.tm_mon })
+		return false;
+	return sae::local_timestamp().year == _tm.tm_year + 1900 && sae::cached_local_timestamp().year == _tm.tm_year + 1900;
+};
+
+int main()
+{
+	if (!test_basic_timer_wheel())
+		return -1;
+	if (!test_timer_wheel())
+		return -1;
+	if (!test_retry())
+		return -1;
+	if (!test_tsc_clock())
+		return -1;
+	if (!test_coarse_clock())
+		return -1;
+	if (!test_precise_sleep())
+		return -1;
+	if (!test_periodic_ithread())
+		return -1;
+	if (!test_local_timestamp())
+		return -1;
+	return 0;
+};
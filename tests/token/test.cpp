@@ -0,0 +1,235 @@
+
+#include <SAELib_Token.h>
+
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <ranges>
+#include <array>
+#include <iterator>
+
+// Straightforward find based split to check the others against
+sae::token_list reference_split(std::string_view _str, char _delim)
+{
+	sae::token_list _out{};
+	size_t _offset = 0;
+	size_t _at = 0;
+	while ((_at = _str.find(_delim, _offset)) != std::string_view::npos)
+	{
+		_out.push_back(_str.substr(_offset, _at - _offset));
+		_offset = _at + 1;
+	};
+	_out.push_back(_str.substr(_offset));
+	return _out;
+};
+
+// Builds a string with a delimiter every _spacing characters on average
+std::string make_input(size_t _length, size_t _spacing)
+{
+	std::string _out{};
+	uint32_t _seed = 12345;
+	for (size_t n = 0; n != _length; ++n)
+	{
+		_seed = _seed * 1103515245 + 12345;
+		_out.push_back(((_seed >> 16) % _spacing == 0) ? ',' : (char)('a' + (n % 26)));
+	};
+	return _out;
+};
+
+bool test_split()
+{
+	for (size_t _length : { 0, 1, 15, 16, 17, 31, 32, 33, 100, 4097 })
+	{
+		for (size_t _spacing : { 1, 2, 5, 40, 1000 })
+		{
+			const auto _input = make_input(_length, _spacing);
+			const auto _expected = reference_split(_input, ',');
+
+			if (sae::split(_input, ',') != _expected)
+				return false;
+
+			sae::token_list _scalar{};
+			auto _sink = [&_scalar](std::string_view _t) { _scalar.push_back(_t); };
+			sae::impl::split_char_scalar(_input, ',', _sink);
+			if (_scalar != _expected)
+				return false;
+		};
+	};
+
+	if (sae::split(std::string_view{ ",," }, ',').size() != 3)
+		return false;
+
+	return true;
+};
+
+bool test_split_view()
+{
+	static_assert(std::ranges::view<sae::split_view>);
+	static_assert(std::ranges::forward_range<sae::split_view>);
+
+	for (size_t _spacing : { 1, 2, 5, 40 })
+	{
+		const auto _input = make_input(1000, _spacing);
+
+		const auto _expected = reference_split(_input, ',');
+		const sae::split_view _view{ _input, ',' };
+		if (!std::ranges::equal(_view, _expected))
+			return false;
+
+		auto _notEmpty = _expected;
+		sae::erase_empty(_notEmpty);
+		if (!std::ranges::equal(sae::split_view{ _input, ',', true }, _notEmpty))
+			return false;
+	};
+
+	// Multi character delimiter
+	if (!std::ranges::equal(sae::split_view{ "a::b::::c", "::" }, sae::token_list{ "a", "b", "", "c" }))
+		return false;
+	if (!std::ranges::equal(sae::split_view{ "::a::b::::", "::", true }, sae::token_list{ "a", "b" }))
+		return false;
+
+	// Empty input gives a single empty token, or nothing when skipping empty tokens
+	if (std::ranges::distance(sae::split_view{ "", ',' }) != 1)
+		return false;
+	if (!sae::split_view{ ",,,", ',', true }.empty())
+		return false;
+
+	return true;
+};
+
+bool test_split_into()
+{
+	const std::string _input = "a,b,,c";
+	const sae::token_list _expected{ "a", "b", "", "c" };
+
+	// Reused list is cleared and keeps its capacity
+	sae::token_list _tokens{ "x", "y", "z", "w", "v" };
+	const auto _capacity = _tokens.capacity();
+	sae::split_into(_input, ',', _tokens);
+	if (_tokens != _expected || _tokens.capacity() != _capacity)
+		return false;
+
+	sae::split_into(std::string_view{ "a::b" }, "::", _tokens);
+	if (_tokens != sae::token_list{ "a", "b" })
+		return false;
+
+	sae::token_list _iterOut{};
+	sae::split_into(std::string_view{ _input }, ',', std::back_inserter(_iterOut));
+	if (_iterOut != _expected)
+		return false;
+
+	std::array<std::string_view, 4> _fits{};
+	auto _result = sae::split_into(_input, ',', _fits);
+	if (_result.size != 4 || _result.overflow || !std::ranges::equal(_fits, _expected))
+		return false;
+
+	std::array<std::string_view, 2> _small{};
+	_result = sae::split_into(_input, ',', _small);
+	if (_result.size != 2 || !_result.overflow || _small[1] != "b")
+		return false;
+
+	return true;
+};
+
+bool test_parallel_split()
+{
+	for (size_t _spacing : { 1, 3, 5000000 })
+	{
+		auto _input = make_input(sae::PARALLEL_SPLIT_MIN_CHUNK_V * 4 + 3, _spacing);
+		_input.push_back(',');
+		if (sae::parallel_split(_input, ',', 4) != reference_split(_input, ','))
+			return false;
+	};
+
+	if (sae::parallel_split("a,b", ',', 4) != sae::token_list{ "a", "b" })
+		return false;
+
+	// No trailing delimiter, delimiters only near the start, and no delimiters at all
+	for (size_t _spacing : { 1, 3, 5000000 })
+	{
+		const auto _input = make_input(sae::PARALLEL_SPLIT_MIN_CHUNK_V * 3 + 7, _spacing);
+		if (sae::parallel_split(_input, ',', 4) != reference_split(_input, ','))
+			return false;
+	};
+
+	std::string _early(sae::PARALLEL_SPLIT_MIN_CHUNK_V * 3, 'a');
+	_early[10] = ',';
+	if (sae::parallel_split(_early, ',', 4) != reference_split(_early, ','))
+		return false;
+	_early[20] = ',';
+	_early[sae::PARALLEL_SPLIT_MIN_CHUNK_V + 5] = ',';
+	if (sae::parallel_split(_early, ',', 4) != reference_split(_early, ','))
+		return false;
+
+	const std::string _none(sae::PARALLEL_SPLIT_MIN_CHUNK_V * 3, 'a');
+	if (sae::parallel_split(_none, ',', 4) != sae::token_list{ _none })
+		return false;
+
+	std::string _last(sae::PARALLEL_SPLIT_MIN_CHUNK_V * 3, 'a');
+	_last.back() = ',';
+	if (sae::parallel_split(_last, ',', 4) != reference_split(_last, ','))
+		return false;
+
+	return true;
+};
+
+bool test_tokenizer()
+{
+	sae::tokenizer _tokenizer{};
+
+	if (_tokenizer.tokenize("  one\ttwo \n three  ") != sae::token_list{ "one", "two", "three" })
+		return false;
+	if (!_tokenizer.tokenize(" \t ").empty())
+		return false;
+
+	// Quoted tokens keep their delimiters and view into the input
+	const std::string_view _quoted = "say \"hello world\" \"\"";
+	const auto _tokens = _tokenizer.tokenize(_quoted);
+	if (_tokens != sae::token_list{ "say", "hello world", "" })
+		return false;
+	if (_tokens[1].data() != _quoted.data() + 5)
+		return false;
+
+	// Quotes in the middle of a token and escapes need unescaped copies
+	if (_tokenizer.tokenize("a\"b c\"d e\\ f \\\"g") != sae::token_list{ "ab cd", "e f", "\"g" })
+		return false;
+
+	// Unescaped storage is reused between calls
+	_tokenizer.tokenize("a\\b \"c\"d");
+	const auto _reused = _tokenizer.tokenize("x\\y \"z\"w");
+	if (_reused != sae::token_list{ "xy", "zw" })
+		return false;
+	if (_tokenizer.tokenize("1\\2 \"3\"4")[0].data() != _reused[0].data())
+		return false;
+
+	// Unterminated quote runs to the end of the input
+	if (_tokenizer.tokenize("x \"y z") != sae::token_list{ "x", "y z" })
+		return false;
+
+	// Terminal configuration, backslashes in paths are kept while quotes still group
+	sae::tokenizer _terminal{ sae::whitespace_delimiters_v, '"', '\0' };
+	if (_terminal.tokenize("cd C:\\dir\\file \"C:\\Program Files\\x\"") != sae::token_list{ "cd", "C:\\dir\\file", "C:\\Program Files\\x" })
+		return false;
+
+	sae::tokenizer _csv{ ",;", '\0', '\0' };
+	if (_csv.tokenize("a,b;;c\"") != sae::token_list{ "a", "b", "c\"" })
+		return false;
+
+	return true;
+};
+
+int main()
+{
+	if (!test_split())
+		return -1;
+	if (!test_split_view())
+		return -1;
+	if (!test_split_into())
+		return -1;
+	if (!test_parallel_split())
+		return -1;
+	if (!test_tokenizer())
+		return -1;
+
+	return 0;
+};